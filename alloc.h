@@ -0,0 +1,56 @@
+// -- allocation counter -- //
+
+// frames ignored after startup
+const dt allocWarmup = 2;
+
+#ifdef X65_DEBUG
+// allocation count since last frame
+std::atomic<dt> allocCount {0};
+
+// c++ allocator hooks
+void* operator new(size_t size) {
+    allocCount++;
+    void* ptr = malloc(size ? size : 1);
+    if (ptr == null)
+        throw std::bad_alloc();
+    return ptr;
+};
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+};
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+};
+
+// sdl allocator hooks
+void* allocMalloc(size_t size) {
+    allocCount++;
+    return malloc(size);
+};
+void* allocCalloc(size_t count, size_t size) {
+    allocCount++;
+    return calloc(count, size);
+};
+void* allocRealloc(void* ptr, size_t size) {
+    allocCount++;
+    return realloc(ptr, size);
+};
+#endif
+
+// install allocator hooks
+void allocHook() {
+    #ifdef X65_DEBUG
+    SDL_SetMemoryFunctions(allocMalloc, allocCalloc, allocRealloc, free);
+    #endif
+};
+
+// report frame allocations
+#ifdef X65_DEBUG
+void allocFrame(dt frame) {
+    dt count = allocCount.exchange(0);
+    if (count && frame >= allocWarmup)
+        printf(" - Frame %u: %u allocations\n", frame, count);
+};
+#else
+void allocFrame(dt) {};
+#endif
@@ -0,0 +1,190 @@
+// -- batched consoles -- //
+
+// exported c api
+#ifdef _WIN32
+#define X65_API extern "C" __declspec(dllexport)
+#else
+#define X65_API extern "C" __attribute__((visibility("default")))
+#endif
+
+// frame buffer size
+const dt framePixels = 320 * 240;
+
+// consoles stepped in lockstep
+struct Batch {
+    Console* consoles = null;
+    dt count = 0;
+    int reward = -1;
+
+    // caller visible arrays
+    Uint32* frames = null;
+    float* rewards = null;
+    wt* scores = null;
+    bool* resets = null;
+    const dt* actions = null;
+
+    // worker pool
+    vec<SDL_Thread*> threads;
+    SDL_sem* start = null;
+    SDL_sem* done = null;
+    std::atomic<dt> next {0};
+    bool stop = false;
+};
+
+// rom and wave data are process globals, so one batch at a time
+Batch* liveBatch = null;
+
+// advance one console by a frame
+void stepConsole(Batch* batch, dt id) {
+    console = &batch->consoles[id];
+    Console& con = *console;
+
+    Input in;
+    in.keys = batch->actions[id];
+    in.reset = batch->resets[id];
+    batch->resets[id] = false;
+    con.gpu.start();
+    runFrame(in);
+
+    // reward is the change of a 16-bit counter in ram
+    if (batch->reward >= 0) {
+        wt score = con.ram[batch->reward] | con.ram[(batch->reward + 1) & 0x3FFF] << 8;
+        batch->rewards[id] = Sint16(score - batch->scores[id]);
+        batch->scores[id] = score;
+    };
+};
+
+// pool thread, takes consoles until none are left
+int batchWorker(void* data) {
+    Batch* batch = (Batch*)data;
+    while (true) {
+        SDL_SemWait(batch->start);
+        if (batch->stop)
+            return 0;
+
+        while (true) {
+            dt id = batch->next++;
+            if (id >= batch->count)
+                break;
+            stepConsole(batch, id);
+        };
+        SDL_SemPost(batch->done);
+    };
+};
+
+// stop workers and free batch
+X65_API void x65_destroy(Batch* batch) {
+    if (batch == null)
+        return;
+
+    batch->stop = true;
+    for (dt i = 0; i < batch->threads.size(); i++)
+        SDL_SemPost(batch->start);
+    for (SDL_Thread* t : batch->threads)
+        SDL_WaitThread(t, null);
+    if (liveBatch == batch)
+        liveBatch = null;
+    if (batch->start) SDL_DestroySemaphore(batch->start);
+    if (batch->done) SDL_DestroySemaphore(batch->done);
+
+    delete[] batch->consoles;
+    delete[] batch->frames;
+    delete[] batch->rewards;
+    delete[] batch->scores;
+    delete[] batch->resets;
+    delete batch;
+};
+
+// create consoles from one rom, zero threads uses one per core
+X65_API Batch* x65_create(st path, dt count, dt threads, Uint64 seed, int reward) {
+    File file = loadFile(path);
+    if (!file.valid || count == 0) {
+        printf(" - Failed to open %s\n", path);
+        return null;
+    };
+    if (liveBatch) {
+        printf(" - Destroy the live batch before creating another\n");
+        return null;
+    };
+
+    // all arrays are allocated once here
+    Batch* batch = new Batch();
+    liveBatch = batch;
+    batch->count = count;
+    batch->reward = reward < 0 ? -1 : reward & 0x3FFF;
+    batch->consoles = new Console[count]();
+    batch->frames = new Uint32[count * framePixels]();
+    batch->rewards = new float[count]();
+    batch->scores = new wt[count]();
+    batch->resets = new bool[count]();
+
+    // consoles render straight into the frame array
+    for (dt i = 0; i < count; i++) {
+        console = &batch->consoles[i];
+        Console& con = *console;
+        if (!con.gpu.createHeadless(batch->frames + i * framePixels)) {
+            printf(" - %s\n", SDL_GetError());
+            console = &primary;
+            x65_destroy(batch);
+            return null;
+        };
+        con.mixer.discard(true);
+
+        powerOn(seed);
+        int errlevel = loadROM(file.data);
+        if (errlevel) {
+            printf(" - Failed to load %s\n", path);
+            console = &primary;
+            x65_destroy(batch);
+            return null;
+        };
+        boot();
+        con.gpu.budget(lineBudget);
+        if (batch->reward >= 0)
+            batch->scores[i] = con.ram[batch->reward] | con.ram[(batch->reward + 1) & 0x3FFF] << 8;
+    };
+    console = &primary;
+
+    // start worker pool
+    if (threads == 0)
+        threads = SDL_GetCPUCount();
+    if (threads > count)
+        threads = count;
+    batch->start = SDL_CreateSemaphore(0);
+    batch->done = SDL_CreateSemaphore(0);
+    for (dt i = 0; i < threads; i++)
+        batch->threads.push_back(SDL_CreateThread(batchWorker, "batch", batch));
+    return batch;
+};
+
+// set key words for every console and run one frame on all of them
+X65_API void x65_step(Batch* batch, const dt* actions) {
+    batch->actions = actions;
+    batch->next = 0;
+    for (dt i = 0; i < batch->threads.size(); i++)
+        SDL_SemPost(batch->start);
+    for (dt i = 0; i < batch->threads.size(); i++)
+        SDL_SemWait(batch->done);
+};
+
+// press reset on one console, taken at its next step on the console's own banks
+X65_API void x65_reset(Batch* batch, dt id) {
+    if (id < batch->count)
+        batch->resets[id] = true;
+};
+
+// argb frames, count x 240 x 320
+X65_API Uint32* x65_frames(Batch* batch) {
+    return batch->frames;
+};
+
+// first console ram, the next one starts stride bytes later
+X65_API bt* x65_ram(Batch* batch, dt* stride) {
+    *stride = sizeof(Console);
+    return batch->consoles[0].ram;
+};
+
+// reward of each console for the last step
+X65_API float* x65_rewards(Batch* batch) {
+    return batch->rewards;
+};
@@ -0,0 +1,464 @@
+// -- synthetic benchmarks -- //
+
+// generated rom layout
+const wt benchCode = 0xF000;
+const wt benchSprites = 0xF800;
+const wt benchPalette = 0xFC00;
+const wt benchVectorBase = 0xFFFA;
+const wt spriteTable = 0x0200;
+const int benchTiles = 64;
+
+// opcodes emitted by the generator
+enum Opcode : bt {
+    OP_AND_DIM = 0x01, OP_ADC_DIM = 0x02, OP_CLC = 0x07,
+    OP_ASL_ACC = 0x14, OP_WAI = 0x18, OP_TAX = 0x1F,
+    OP_JSR_DIR = 0x20, OP_ORA_DIM = 0x21, OP_TAY = 0x2F,
+    OP_LSR_ACC = 0x34, OP_SEI = 0x37,
+    OP_RTI = 0x40, OP_XOR_DIM = 0x41, OP_INX = 0x42, OP_STZ_DIR = 0x46, OP_CLF = 0x47, OP_TXA = 0x4F,
+    OP_ROL_ACC = 0x54, OP_SEF = 0x57,
+    OP_RTS = 0x60, OP_LTA_DIM = 0x61, OP_DEX = 0x62, OP_STA_DIR = 0x66, OP_INC_ACC = 0x67, OP_LTA_DRX = 0x69, OP_STA_DRX = 0x6A,
+    OP_DEY = 0x72, OP_ROR_ACC = 0x74, OP_LTA_ZPG = 0x75, OP_STA_ZPG = 0x76,
+    OP_LTB_DIM = 0x81, OP_TXS = 0x8F,
+    OP_BCC = 0x90, OP_CMP_DIM = 0x94,
+    OP_MUL = 0xA0, OP_LTX_DIM = 0xA1, OP_STX_DIR = 0xA6,
+    OP_CPX_DIM = 0xB4,
+    OP_DIV = 0xC0, OP_LTY_DIM = 0xC1, OP_BRA = 0xCF,
+    OP_BNE = 0xD0,
+    OP_MOD = 0xE0, OP_LTV = 0xE1, OP_STD_DIR = 0xE6, OP_LTD_DRX = 0xE9, OP_STD_DRX = 0xEA,
+    OP_LTD_IMM = 0xF1
+};
+
+// program page under construction
+class Code {
+    public:
+    Code(bt* page, wt base) : m_data(page), m_base(base) {};
+
+    // instruction with no, byte or word operand
+    void op(bt code) {
+        m_data[m_pos++] = code;
+    };
+    void op8(bt code, bt value) {
+        op(code);
+        m_data[m_pos++] = value;
+    };
+    void op16(bt code, wt value) {
+        op(code);
+        m_data[m_pos++] = value & 0xFF;
+        m_data[m_pos++] = value >> 8;
+    };
+
+    // relative branch back to address
+    void branch(bt code, wt target) {
+        op8(code, target - (here() + 2));
+    };
+    // branch to a later label, resolved by land
+    wt forward(bt code) {
+        op8(code, 0);
+        return m_pos - 1;
+    };
+    void land(wt from) {
+        m_data[from] = m_pos - (from + 1);
+    };
+
+    // cpu address of next byte
+    wt here() {
+        return m_base + m_pos;
+    };
+    // raw data at address
+    void at(wt addr) {
+        m_pos = addr - m_base;
+    };
+    void byte(bt value) {
+        m_data[m_pos++] = value;
+    };
+    void word(wt value) {
+        byte(value & 0xFF);
+        byte(value >> 8);
+    };
+
+    private:
+    bt* m_data;
+    wt m_base;
+    wt m_pos = 0;
+};
+
+// generated cartridge contents
+struct Cart {
+    st name;
+    vec<bt> prg;
+    vec<bt> dsd;
+};
+
+// stack, interrupts off, integer arithmetic
+void benchInit(Code& code) {
+    code.op(OP_SEI);
+    code.op(OP_CLF);
+    code.op16(OP_LTX_DIM, 0x1000);
+    code.op(OP_LTV);
+    code.op16(OP_LTX_DIM, 0x1FFF);
+    code.op(OP_TXS);
+};
+
+// copy palette table into cgram
+void benchPalettes(Code& code) {
+    code.op16(OP_LTX_DIM, 0x0000);
+    code.op16(OP_STX_DIR, 0x4004);
+    wt loop = code.here();
+    code.op16(OP_LTA_DRX, benchPalette);
+    code.op16(OP_STA_DIR, 0x4000);
+    code.op(OP_INX);
+    code.op(OP_INX);
+    code.op16(OP_CPX_DIM, 0x200);
+    code.branch(OP_BCC, loop);
+
+    // opaque colors, first of each palette is transparent
+    wt resume = code.here();
+    code.at(benchPalette);
+    for (int i = 0; i < 256; i++) {
+        bt r = i * 7 & 15;
+        bt g = i * 3 & 15;
+        bt b = i >> 4;
+        code.byte(r << 4 | g);
+        code.byte(b << 4 | (i & 15 ? 15 : 0));
+    };
+    code.at(resume);
+};
+
+// vectors, irq returns at once
+void benchVectors(Code& code, wt reset, wt nmi) {
+    code.at(benchVectorBase - 1);
+    wt irq = code.here();
+    code.op(OP_RTI);
+    code.word(irq);
+    code.word(reset);
+    code.word(nmi);
+};
+
+// wait for interrupts forever
+wt benchIdle(Code& code) {
+    wt idle = code.here();
+    code.op(OP_WAI);
+    code.branch(OP_BRA, idle);
+    return code.here();
+};
+
+// alu and data dependent branches, never waits
+Cart benchAlu() {
+    Cart cart = {"alu", vec<bt>(0x1000), vec<bt>()};
+    Code code(cart.prg.data(), benchCode);
+    benchInit(code);
+
+    wt outer = code.here();
+    code.op16(OP_LTX_DIM, 0x4000);
+    code.op16(OP_LTA_DIM, 0x1234);
+    wt inner = code.here();
+    code.op16(OP_ADC_DIM, 0x0F0F);
+    code.op16(OP_XOR_DIM, 0x5A5A);
+    code.op(OP_ASL_ACC);
+    code.op(OP_ROL_ACC);
+    code.op16(OP_AND_DIM, 0x7FFF);
+    code.op(OP_LSR_ACC);
+    code.op16(OP_CMP_DIM, 0x2000);
+    wt skip = code.forward(OP_BCC);
+    code.op(OP_INC_ACC);
+    code.op(OP_ROR_ACC);
+    code.land(skip);
+    code.op(OP_TAY);
+    code.op(OP_DEX);
+    code.branch(OP_BNE, inner);
+    code.branch(OP_BRA, outer);
+
+    benchVectors(code, benchCode, benchCode);
+    return cart;
+};
+
+// multiply, divide and modulo in integer and fixed point
+Cart benchMath() {
+    Cart cart = {"muldiv", vec<bt>(0x1000), vec<bt>()};
+    Code code(cart.prg.data(), benchCode);
+    benchInit(code);
+
+    code.op16(OP_LTX_DIM, 0x0000);
+    wt loop = code.here();
+    code.op(OP_TXA);
+    code.op16(OP_LTB_DIM, 0x0123);
+    code.op(OP_MUL);
+    code.op16(OP_LTB_DIM, 0x0007);
+    code.op(OP_DIV);
+    code.op16(OP_LTB_DIM, 0x0011);
+    code.op(OP_MOD);
+    code.op(OP_SEF);
+    code.op16(OP_LTB_DIM, 0x0180);
+    code.op(OP_MUL);
+    code.op16(OP_LTB_DIM, 0x0003);
+    code.op(OP_DIV);
+    code.op(OP_CLF);
+    code.op(OP_INX);
+    code.branch(OP_BRA, loop);
+
+    benchVectors(code, benchCode, benchCode);
+    return cart;
+};
+
+// stream every room of both layers through $4000 in one head mode
+Cart benchVram(int head) {
+    static st names[4] = {"vram-right", "vram-left", "vram-down", "vram-up"};
+    Cart cart = {names[head], vec<bt>(0x1000), vec<bt>()};
+    Code code(cart.prg.data(), benchCode);
+    benchInit(code);
+    benchPalettes(code);
+
+    // both layers on, head steps right, left, down or up
+    code.op8(OP_LTD_IMM, 0x30 | head);
+    code.op16(OP_STD_DIR, 0x4002);
+    code.op16(OP_STZ_DIR, 0x4003);
+
+    // tile and attribute blocks of four rooms per layer
+    wt start = head & 1 ? 0x4AF : 0x000;
+    wt restart = code.here();
+    code.op16(OP_LTX_DIM, 0x8000);
+    wt block = code.here();
+    code.op(OP_TXA);
+    code.op16(OP_ORA_DIM, start);
+    code.op16(OP_STA_DIR, 0x4004);
+    code.op16(OP_LTY_DIM, 1200);
+    wt write = code.here();
+    code.op16(OP_STD_DIR, 0x4000);
+    code.op(OP_INC_ACC);
+    code.op(OP_DEY);
+    code.branch(OP_BNE, write);
+    code.op(OP_TXA);
+    code.op(OP_CLC);
+    code.op16(OP_ADC_DIM, 0x0800);
+    code.op(OP_TAX);
+    code.branch(OP_BNE, block);
+    code.branch(OP_BRA, restart);
+
+    benchVectors(code, benchCode, benchCode);
+    return cart;
+};
+
+// 128 sprites spread over all three layers, moved every frame
+Cart benchSpriteMotion() {
+    Cart cart = {"sprites", vec<bt>(0x1000), vec<bt>()};
+    Code code(cart.prg.data(), benchCode);
+    benchInit(code);
+    benchPalettes(code);
+
+    // copy initial attributes to ram
+    code.op16(OP_LTX_DIM, 0x0000);
+    wt copy = code.here();
+    code.op16(OP_LTA_DRX, benchSprites);
+    code.op16(OP_STA_DRX, spriteTable);
+    code.op(OP_INX);
+    code.op(OP_INX);
+    code.op16(OP_CPX_DIM, 0x300);
+    code.branch(OP_BCC, copy);
+
+    // dma from table, nmi, sprites and both layers on
+    code.op16(OP_LTX_DIM, spriteTable);
+    code.op16(OP_STX_DIR, 0x4006);
+    code.op8(OP_LTD_IMM, 0xF0);
+    code.op16(OP_STD_DIR, 0x4002);
+    code.op16(OP_STZ_DIR, 0x4003);
+    wt nmi = benchIdle(code);
+
+    // step x right and y down, wrapping at 256
+    code.op16(OP_LTX_DIM, 0x0000);
+    wt move = code.here();
+    code.op16(OP_LTD_DRX, spriteTable);
+    code.op(OP_INC_ACC);
+    code.op16(OP_STD_DRX, spriteTable);
+    code.op16(OP_LTD_DRX, spriteTable + 0x100);
+    code.op(OP_INC_ACC);
+    code.op16(OP_STD_DRX, spriteTable + 0x100);
+    code.op(OP_INX);
+    code.op(OP_INX);
+    code.op16(OP_CPX_DIM, 0x100);
+    code.branch(OP_BCC, move);
+    code.op(OP_RTI);
+
+    // x, y and tile words, layer i % 3 and palette i % 16
+    code.at(benchSprites);
+    for (int i = 0; i < 128; i++)
+        code.word(i * 37 & 0xFF);
+    for (int i = 0; i < 128; i++)
+        code.word(i * 53 % 240);
+    for (int i = 0; i < 128; i++)
+        code.word((i % benchTiles) | (i % 3) << 10 | (i & 15) << 12);
+
+    benchVectors(code, benchCode, nmi);
+    return cart;
+};
+
+// all eight channels looping on their own wave, retuned every frame
+Cart benchAudio() {
+    Cart cart = {"audio", vec<bt>(0x1000), vec<bt>(8 * waveSize)};
+    Code code(cart.prg.data(), benchCode);
+    benchInit(code);
+
+    // frequency, volume, loop from start and wave per channel
+    for (int c = 0; c < 8; c++) {
+        code.op16(OP_LTA_DIM, 0x1000 + c * 0x0340);
+        code.op16(OP_STA_DIR, 0x5000 + c * 2);
+        code.op16(OP_LTA_DIM, 0x4040);
+        code.op16(OP_STA_DIR, 0x5010 + c * 2);
+        code.op16(OP_LTA_DIM, 0x0000);
+        code.op16(OP_STA_DIR, 0x5020 + c * 2);
+        code.op8(OP_LTD_IMM, c);
+        code.op16(OP_STD_DIR, 0x5030 + c * 2);
+    };
+    code.op8(OP_LTD_IMM, 0xFF);
+    code.op16(OP_STD_DIR, 0x5040);
+    code.op8(OP_LTD_IMM, 0x80);
+    code.op16(OP_STD_DIR, 0x4002);
+    wt nmi = benchIdle(code);
+
+    // sweep a shared frequency offset through every channel
+    code.op8(OP_LTA_ZPG, 0x00);
+    code.op(OP_CLC);
+    code.op16(OP_ADC_DIM, 0x0010);
+    code.op16(OP_AND_DIM, 0x0FFF);
+    code.op8(OP_STA_ZPG, 0x00);
+    for (int c = 0; c < 8; c++) {
+        code.op16(OP_ADC_DIM, 0x0340);
+        code.op16(OP_STA_DIR, 0x5000 + c * 2);
+    };
+    code.op(OP_RTI);
+    benchVectors(code, benchCode, nmi);
+
+    // sine, square, saw, triangle and harmonics
+    for (int w = 0; w < 8; w++) {
+        for (int i = 0; i < waveSize; i++) {
+            double t = double(i) / waveSize;
+            double v = 0;
+            switch (w & 3) {
+                case 0: v = sin(t * 2 * M_PI * (w / 4 + 1)); break;
+                case 1: v = t < 0.5 ? 0.8 : -0.8; break;
+                case 2: v = t * 2 - 1; break;
+                case 3: v = 1 - fabs(t * 4 - 2); break;
+            };
+            cart.dsd[w * waveSize + i] = bt(128 + v * 100);
+        };
+    };
+    return cart;
+};
+
+// code and data fetched through pages remapped on every call
+Cart benchBanks() {
+    Cart cart = {"banks", vec<bt>(8 * 0x1000), vec<bt>()};
+    Code code(cart.prg.data(), benchCode);
+    benchInit(code);
+
+    // map page counter + slot mod 7 + 1 into each low slot and call it
+    code.op16(OP_LTB_DIM, 7);
+    wt loop = code.here();
+    for (int s = 0; s < 7; s++) {
+        code.op8(OP_LTA_ZPG, 0x00);
+        code.op(OP_CLC);
+        code.op16(OP_ADC_DIM, s);
+        code.op(OP_MOD);
+        code.op(OP_INC_ACC);
+        code.op16(OP_STD_DIR, 0x4010 + s);
+        code.op16(OP_JSR_DIR, 0x8000 + s * 0x1000);
+    };
+    code.op8(OP_LTA_ZPG, 0x00);
+    code.op(OP_INC_ACC);
+    code.op8(OP_STA_ZPG, 0x00);
+    code.branch(OP_BRA, loop);
+    benchVectors(code, benchCode, benchCode);
+
+    // position independent routine on every other page
+    for (int p = 1; p < 8; p++) {
+        Code page(cart.prg.data() + p * 0x1000, 0x8000);
+        page.op16(OP_ADC_DIM, p);
+        page.op(OP_RTS);
+    };
+    return cart;
+};
+
+// header, prg, dsd and shared tiles
+vec<bt> cartImage(Cart& cart) {
+    vec<bt> data(0x10, 0);
+    data[0] = 'x';
+    data[1] = '6';
+    data[2] = '5';
+    data[4] = (cart.prg.size() >> 12) & 0xFF;
+    data[5] = cart.prg.size() >> 20;
+    data[6] = cart.dsd.size() / waveSize;
+    data.insert(data.end(), cart.prg.begin(), cart.prg.end());
+    data.insert(data.end(), cart.dsd.begin(), cart.dsd.end());
+
+    // diagonal stripes, offset per tile
+    for (int t = 0; t < benchTiles; t++) {
+        for (int y = 0; y < 8; y++) {
+            for (int x = 0; x < 8; x += 2) {
+                bt a = (x + y + t) & 15;
+                bt b = (x + 1 + y + t) & 15;
+                data.push_back(a << 4 | b);
+            };
+        };
+    };
+    return data;
+};
+
+// run loaded rom on the instruction budget and print one csv row
+int measure(st path, dt frames) {
+    static Uint16 audio[captureSamples * 2];
+    vec<Uint64> times(frames);
+
+    Uint64 start = Pacer::now();
+    for (dt frame = 0; frame < frames; frame++) {
+        Uint64 begin = Pacer::now();
+        runFrame();
+        console->mixer.advance(console->gpu.lines() + 1);
+        console->mixer.drain(audio, captureSamples);
+        times[frame] = Pacer::now() - begin;
+        logFrame();
+    };
+    double seconds = double(Pacer::now() - start) / 1000000000.0;
+
+    // frame cost distribution
+    Uint64 total = 0;
+    for (Uint64 t : times)
+        total += t;
+    std::sort(times.begin(), times.end());
+    double mean = frames ? total / 1000.0 / frames : 0;
+    double p50 = frames ? times[frames / 2] / 1000.0 : 0;
+    double p99 = frames ? times[frames * 99 / 100] / 1000.0 : 0;
+    double max = frames ? times[frames - 1] / 1000.0 : 0;
+
+    Uint64 count = console->gpu.retired();
+    printf("%s,%u,%llu,%.3f,%.0f,%.1f,%.1f,%.1f,%.1f,%.1f\n", path, frames, (unsigned long long)count, seconds, count / seconds, frames / seconds, mean, p50, p99, max);
+    return 0;
+};
+
+// write generated roms into dir and measure each in its own process
+int bench(st self, st dir, dt frames) {
+    Cart carts[] = {benchAlu(), benchMath(), benchVram(0), benchVram(1), benchVram(2), benchVram(3), benchSpriteMotion(), benchAudio(), benchBanks()};
+
+    printf("rom,frames,instructions,seconds,instructions_per_sec,frames_per_sec,frame_us_mean,frame_us_p50,frame_us_p99,frame_us_max\n");
+    fflush(stdout);
+    int failed = 0;
+    for (Cart& cart : carts) {
+        std::string path = std::string(dir) + "/" + cart.name + ".x65";
+        File file;
+        file.name = path.c_str();
+        file.valid = true;
+        file.data = cartImage(cart);
+        if (!saveFile(file)) {
+            printf(" - Failed to write %s\n", path.c_str());
+            return 2;
+        };
+
+        // one at a time so runs do not compete for cores
+        std::string cmd = "\"" + std::string(self) + "\" \"" + path + "\" --measure --frames " + std::to_string(frames);
+        #ifdef _WIN32
+        cmd = "\"" + cmd + "\"";
+        #endif
+        if (system(cmd.c_str()) != 0)
+            failed++;
+        fflush(stdout);
+    };
+    return failed ? 8 : 0;
+};
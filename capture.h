@@ -0,0 +1,191 @@
+// -- offline capture -- //
+
+// capture constants
+const int captureDepth = 8;
+const int captureSamples = 4096;
+
+// captured frame
+struct Shot {
+    Uint32 pixels[320 * 240];
+    Uint16 audio[captureSamples * 2];
+    int samples;
+};
+
+// little endian helpers
+void put16(FILE* file, Uint16 value) {
+    fputc(value & 0xFF, file);
+    fputc(value >> 8, file);
+};
+void put32(FILE* file, Uint32 value) {
+    put16(file, value & 0xFFFF);
+    put16(file, value >> 16);
+};
+
+// capture writer
+class Capture {
+    public:
+    // open output files and start writer
+    bool open(st base) {
+        char video[512], audio[512];
+        snprintf(video, sizeof(video), "%s.y4m", base);
+        snprintf(audio, sizeof(audio), "%s.wav", base);
+        m_video = fopen(video, "wb");
+        m_audio = fopen(audio, "wb");
+
+        // remove the file that did open so close() leaves nothing behind
+        if (!m_video || !m_audio) {
+            if (m_video) {
+                fclose(m_video);
+                remove(video);
+            };
+            if (m_audio) {
+                fclose(m_audio);
+                remove(audio);
+            };
+            m_video = null;
+            m_audio = null;
+            return false;
+        };
+
+        // stream headers
+        fprintf(m_video, "YUV4MPEG2 W320 H240 F%u:1 Ip A1:1 C444 XCOLORRANGE=FULL\n", dt(frameRate));
+        writeWave(0);
+        m_bytes = 0;
+
+        // bounded queue of frame slots
+        m_shots = new Shot[captureDepth];
+        m_free = SDL_CreateSemaphore(captureDepth);
+        m_full = SDL_CreateSemaphore(0);
+        m_head = 0;
+        m_tail = 0;
+        m_thread = SDL_CreateThread(writer, "capture", this);
+        return true;
+    };
+
+    // queue frame and its audio, waits when the writer falls behind
+    void push(SDL_Surface* frame, Mixer& mixer) {
+        SDL_SemWait(m_free);
+        Shot& shot = m_shots[m_head];
+        for (int y = 0; y < 240; y++)
+            memcpy(shot.pixels + y * 320, (Uint8*)frame->pixels + y * frame->pitch, 320 * 4);
+        shot.samples = mixer.drain(shot.audio, captureSamples);
+
+        m_head = (m_head + 1) % captureDepth;
+        SDL_SemPost(m_full);
+    };
+
+    // flush queue and finish files
+    void close() {
+        if (m_thread) {
+            SDL_SemWait(m_free);
+            m_shots[m_head].samples = -1;
+            SDL_SemPost(m_full);
+            SDL_WaitThread(m_thread, null);
+            SDL_DestroySemaphore(m_free);
+            SDL_DestroySemaphore(m_full);
+            delete[] m_shots;
+            m_thread = null;
+        };
+
+        // patch wave sizes
+        if (m_audio) {
+            fseek(m_audio, 0, SEEK_SET);
+            writeWave(m_bytes);
+            fclose(m_audio);
+            m_audio = null;
+        };
+        if (m_video) {
+            fclose(m_video);
+            m_video = null;
+        };
+    };
+
+    private:
+    // writer thread
+    static int writer(void* data) {
+        Capture* cap = (Capture*)data;
+        while (true) {
+            SDL_SemWait(cap->m_full);
+            Shot& shot = cap->m_shots[cap->m_tail];
+            if (shot.samples < 0)
+                return 0;
+
+            cap->writeFrame(shot);
+            cap->m_tail = (cap->m_tail + 1) % captureDepth;
+            SDL_SemPost(cap->m_free);
+        };
+    };
+
+    // encode full range bt.601 planes
+    void writeFrame(Shot& shot) {
+        static bt planes[3][320 * 240];
+        for (int i = 0; i < 320 * 240; i++) {
+            int r = (shot.pixels[i] >> 16) & 0xFF;
+            int g = (shot.pixels[i] >> 8) & 0xFF;
+            int b = shot.pixels[i] & 0xFF;
+            planes[0][i] = (77 * r + 150 * g + 29 * b + 128) >> 8;
+            planes[1][i] = ((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128;
+            planes[2][i] = ((128 * r - 107 * g - 21 * b + 128) >> 8) + 128;
+        };
+        fputs("FRAME\n", m_video);
+        fwrite(planes, 1, sizeof(planes), m_video);
+
+        // signed pcm from unsigned mixer output
+        for (int i = 0; i < shot.samples * 2; i++)
+            put16(m_audio, shot.audio[i] ^ 0x8000);
+        m_bytes += shot.samples * 4;
+    };
+
+    // riff header for 16-bit stereo pcm
+    void writeWave(dt bytes) {
+        fwrite("RIFF", 1, 4, m_audio);
+        put32(m_audio, 36 + bytes);
+        fwrite("WAVEfmt ", 1, 8, m_audio);
+        put32(m_audio, 16);
+        put16(m_audio, 1);
+        put16(m_audio, 2);
+        put32(m_audio, sampleRate);
+        put32(m_audio, sampleRate * 4);
+        put16(m_audio, 4);
+        put16(m_audio, 16);
+        fwrite("data", 1, 4, m_audio);
+        put32(m_audio, bytes);
+    };
+
+    FILE* m_video = null;
+    FILE* m_audio = null;
+    dt m_bytes = 0;
+
+    // writer queue
+    Shot* m_shots = null;
+    SDL_sem* m_free = null;
+    SDL_sem* m_full = null;
+    SDL_Thread* m_thread = null;
+    int m_head = 0;
+    int m_tail = 0;
+};
+
+// run headless for a number of frames as fast as possible
+int capture(st base, dt frames) {
+    Capture cap;
+    if (!cap.open(base)) {
+        printf(" - Failed to open capture files\n");
+        cap.close();
+        return 6;
+    };
+
+    // frames run on the fixed instruction budget
+    Uint64 start = Pacer::now();
+    for (dt frame = 0; frame < frames; frame++) {
+        runFrame();
+        console->mixer.advance(console->gpu.lines() + 1);
+        cap.push(console->gpu.frame(), console->mixer);
+        logFrame();
+    };
+    cap.close();
+
+    // report speed
+    double time = double(Pacer::now() - start) / 1000000000.0;
+    printf(" - Captured %u frames in %.2f s, %.1fx realtime\n", frames, time, double(frames) / frameRate / time);
+    return 0;
+};
@@ -0,0 +1,184 @@
+// -- scanline compositor -- //
+
+// simd availability
+#if defined(__x86_64__) || defined(__i386__)
+#define X65_SIMD
+#define TARGET(x) __attribute__((target(x)))
+#endif
+
+// compositor function
+typedef void (*compf)(Uint32* dst, Uint32 back, const Uint32* const* src, int count, int width);
+
+// blend single channel
+inline Uint32 blendChannel(Uint32 d, Uint32 s, Uint32 a) {
+    Uint32 t = s * a + d * (255 - a) + 128;
+    return (t + (t >> 8)) >> 8;
+};
+
+// blend single pixel
+inline Uint32 blendPixel(Uint32 d, Uint32 s) {
+    Uint32 a = s >> 24;
+    if (a == 0xFF) return s;
+    if (a == 0x00) return d;
+
+    return blendChannel(d & 0xFF, s & 0xFF, a)
+        | blendChannel((d >> 8) & 0xFF, (s >> 8) & 0xFF, a) << 8
+        | blendChannel((d >> 16) & 0xFF, (s >> 16) & 0xFF, a) << 16;
+};
+
+// scalar compositor
+void composeScalar(Uint32* dst, Uint32 back, const Uint32* const* src, int count, int width) {
+    for (int x = 0; x < width; x++) {
+        Uint32 d = back;
+        for (int i = 0; i < count; i++)
+            d = blendPixel(d, src[i][x]);
+        dst[x] = d | 0xFF000000;
+    };
+};
+
+#ifdef X65_SIMD
+// sse2 compositor
+TARGET("sse2") inline __m128i blendSSE2(__m128i d, __m128i s) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c128 = _mm_set1_epi16(128);
+    const __m128i c255 = _mm_set1_epi16(255);
+
+    // broadcast pixel alpha to all channels
+    __m128i alo = _mm_unpacklo_epi8(s, zero);
+    __m128i ahi = _mm_unpackhi_epi8(s, zero);
+    alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(alo, 0xFF), 0xFF);
+    ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(ahi, 0xFF), 0xFF);
+
+    // s * a + d * (255 - a)
+    __m128i lo = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), alo),
+        _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(c255, alo))
+    );
+    __m128i hi = _mm_add_epi16(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), ahi),
+        _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(c255, ahi))
+    );
+
+    // divide by 255
+    lo = _mm_add_epi16(lo, c128);
+    hi = _mm_add_epi16(hi, c128);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+    return _mm_packus_epi16(lo, hi);
+};
+TARGET("sse2") void composeSSE2(Uint32* dst, Uint32 back, const Uint32* const* src, int count, int width) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i amask = _mm_set1_epi32(0xFF000000);
+
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i d = _mm_set1_epi32(back);
+
+        for (int i = 0; i < count; i++) {
+            __m128i s = _mm_loadu_si128((const __m128i*)(src[i] + x));
+            __m128i a = _mm_and_si128(s, amask);
+            __m128i clear = _mm_cmpeq_epi32(a, zero);
+            int opaque = _mm_movemask_epi8(_mm_cmpeq_epi32(a, amask));
+            int empty = _mm_movemask_epi8(clear);
+
+            // masked select for fully opaque or clear pixels
+            if (empty == 0xFFFF)
+                continue;
+            if ((opaque | empty) == 0xFFFF) {
+                d = _mm_or_si128(_mm_and_si128(clear, d), _mm_andnot_si128(clear, s));
+                continue;
+            };
+
+            // translucent pixels
+            d = blendSSE2(d, s);
+        };
+        _mm_storeu_si128((__m128i*)(dst + x), _mm_or_si128(d, amask));
+    };
+
+    // leftover pixels
+    if (x < width) {
+        const Uint32* rest[8];
+        for (int i = 0; i < count; i++)
+            rest[i] = src[i] + x;
+        composeScalar(dst + x, back, rest, count, width - x);
+    };
+};
+
+// avx2 compositor
+TARGET("avx2") inline __m256i blendAVX2(__m256i d, __m256i s) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i c128 = _mm256_set1_epi16(128);
+    const __m256i c255 = _mm256_set1_epi16(255);
+
+    // broadcast pixel alpha to all channels
+    __m256i alo = _mm256_unpacklo_epi8(s, zero);
+    __m256i ahi = _mm256_unpackhi_epi8(s, zero);
+    alo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(alo, 0xFF), 0xFF);
+    ahi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(ahi, 0xFF), 0xFF);
+
+    // s * a + d * (255 - a)
+    __m256i lo = _mm256_add_epi16(
+        _mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), alo),
+        _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(c255, alo))
+    );
+    __m256i hi = _mm256_add_epi16(
+        _mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), ahi),
+        _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(c255, ahi))
+    );
+
+    // divide by 255
+    lo = _mm256_add_epi16(lo, c128);
+    hi = _mm256_add_epi16(hi, c128);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+    return _mm256_packus_epi16(lo, hi);
+};
+TARGET("avx2") void composeAVX2(Uint32* dst, Uint32 back, const Uint32* const* src, int count, int width) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i amask = _mm256_set1_epi32(0xFF000000);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i d = _mm256_set1_epi32(back);
+
+        for (int i = 0; i < count; i++) {
+            __m256i s = _mm256_loadu_si256((const __m256i*)(src[i] + x));
+            __m256i a = _mm256_and_si256(s, amask);
+            __m256i clear = _mm256_cmpeq_epi32(a, zero);
+            int opaque = _mm256_movemask_epi8(_mm256_cmpeq_epi32(a, amask));
+            int empty = _mm256_movemask_epi8(clear);
+
+            // masked select for fully opaque or clear pixels
+            if (empty == -1)
+                continue;
+            if ((opaque | empty) == -1) {
+                d = _mm256_blendv_epi8(s, d, clear);
+                continue;
+            };
+
+            // translucent pixels
+            d = blendAVX2(d, s);
+        };
+        _mm256_storeu_si256((__m256i*)(dst + x), _mm256_or_si256(d, amask));
+    };
+
+    // leftover pixels
+    if (x < width) {
+        const Uint32* rest[8];
+        for (int i = 0; i < count; i++)
+            rest[i] = src[i] + x;
+        composeScalar(dst + x, back, rest, count, width - x);
+    };
+};
+#endif
+
+// select compositor for host cpu
+compf composer() {
+    #ifdef X65_SIMD
+    if (SDL_HasAVX2())
+        return composeAVX2;
+    if (SDL_HasSSE2())
+        return composeSSE2;
+    #endif
+    return composeScalar;
+};
@@ -1,154 +1,302 @@
-// -- core file -- //
-
-// include libraries
-#include <SDL2/SDL.h>
-#include <windows.h>
-#include <stdio.h>
-#include <vector>
-#include <math.h>
-
-// define types
-#define null __null
-#define vec std::vector
-typedef unsigned short wt;
-typedef unsigned char bt;
-typedef unsigned int dt;
-typedef const char* st;
-typedef void (*proc)();
-typedef char* mt;
-
-// include project
-#include "types.h"
-#include "macros.h"
-#include "x65-cpu.h"
-using namespace x65;
-#include "x65-gpu.h"
-#include "x65-apu.h"
-
-// device assembly
-#include "asm.h"
-
-// file manager
-#include "file.h"
-
-// program entry
-int main(int argc, mt* argv) {
-    if (argc < 2)
-        return 0;
-
-    // initialize sdl
-    if (SDL_Init(SDL_INIT_EVERYTHING)) {
-        printf(" - %s\n", SDL_GetError());
-        return 1;
-    };
-
-    // save file name
-    char filename[512];
-    sprintf(filename, "%s.sav", argv[1]);
-
-    // open rom
-    File file = loadFile(argv[1]);
-    if (!file.valid) {
-        printf(" - Failed to open %s\n", argv[1]);
-        return 2;
-    };
-
-    // init audio
-    if (!APU::create(sampleRate)) {
-        printf(" - %s\n", SDL_GetError());
-        return 3;
-    };
-
-    // try to open joystick
-    if (SDL_NumJoysticks() > 0) {
-        joy1 = SDL_JoystickOpen(0);
-        joy2 = SDL_JoystickOpen(1);
-        gpu.setJoystickUse(joy1 || joy2);
-    };
-
-    // init window
-    if (!gpu.create("X65", 320 * 2, 240 * 2)) {
-        printf(" - %s\n", SDL_GetError());
-        return 4;
-    };
-
-    // randomize memory state
-    for (int i = 0; i < 0x4000; i++)
-        ram[i] = rand() & 0xFF;
-    cpu.a = rand();
-    cpu.b = rand();
-    cpu.x = rand();
-    cpu.y = rand();
-
-    // parse rom
-    int errlevel = loadROM(file.data);
-    if (errlevel) {
-        // load error rom
-        File errc = loadFile(rootFile("error.x65"));
-        if (!errc.valid) {
-            printf(" - Failed to open error cart\n");
-            return 5;
-        };
-
-        int ferr = loadROM(errc.data);
-        if (ferr)
-            return ferr;
-
-        ram[0x00] = errlevel;
-    };
-
-    // load save file
-    if (sram) {
-        File save = loadFile(filename);
-        if (save.valid) {
-            if (save.data.size() == 0x10000) {
-                for (dt i = 0; i < save.data.size(); i++) {
-                    sav[i] = save.data[i];
-                };
-            } else {
-                printf(" - Save file should be 64K long\n");
-            };
-        };
-    };
-
-    // cpu mapping
-    cpu.set = &set;
-    cpu.get = &get;
-
-    // initial reset
-    vectorRST(cpu);
-
-    // main loop
-    while (gpu.running()) {
-        gpu.start();
-        gpu.events(cpu, joy1, joy2);
-        gpu.update(joy1, joy2);
-
-        if (gpu.nmi()) {
-            vectorNMI(cpu);
-        };
-
-        gpu.render(get);
-        gpu.stop(act);
-    };
-
-    // close joystick
-    if (joy1)
-        SDL_JoystickClose(joy1);
-    if (joy2)
-        SDL_JoystickClose(joy2);
-
-    // save SRAM
-    if (sram) {
-        File sf;
-        sf.name = filename;
-        sf.valid = true;
-        for (int i = 0; i < 0x10000; i++)
-            sf.data.push_back(sav[i]);
-        saveFile(sf);
-    };
-
-    // success
-    SDL_CloseAudio();
-    return 0;
-};
+// -- core file -- //
+
+// include libraries
+#include <SDL2/SDL.h>
+#ifdef _WIN32
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <new>
+#include <chrono>
+#include <algorithm>
+#include <math.h>
+#include <immintrin.h>
+
+// define types
+#define null __null
+#define vec std::vector
+typedef unsigned short wt;
+typedef unsigned char bt;
+typedef unsigned int dt;
+typedef const char* st;
+typedef void (*proc)();
+typedef bool (*stepf)();
+typedef char* mt;
+
+// include project
+#include "alloc.h"
+#include "types.h"
+#include "macros.h"
+#include "compose.h"
+#include "scale.h"
+#include "pacer.h"
+#include "queue.h"
+#include "telemetry.h"
+#include "x65-cpu.h"
+using namespace x65;
+#include "x65-gpu.h"
+#include "x65-apu.h"
+#include "movie.h"
+
+// device assembly
+#include "asm.h"
+
+// file manager
+#include "file.h"
+
+// command line
+#include "options.h"
+
+// save states
+#include "state.h"
+
+// offline capture and regression
+#include "capture.h"
+#include "golden.h"
+
+// synthetic benchmarks
+#include "bench.h"
+
+// rollback netplay
+#include "net.h"
+
+// shared memory export
+#include "shared.h"
+
+// batched consoles for training loops
+#ifdef X65_BATCH
+#include "batch.h"
+#else
+
+// emulation thread
+int emulate(void* data) {
+    Options* opt = (Options*)data;
+    Console& con = *console;
+    if (opt->player && !netplay.connect())
+        return 0;
+
+    for (dt frame = 0; con.gpu.running(); frame++) {
+        if (opt->player)
+            netplay.frame();
+        else if (opt->ahead)
+            runAhead(opt->ahead);
+        else
+            runFrame();
+
+        // export before the back buffer is handed off
+        if (opt->shared)
+            shared.write(frame, con.gpu.drawing() ? con.gpu.frame() : null, con.ram);
+        con.gpu.publish();
+        con.gpu.stop(act);
+        if (con.gpu.probing())
+            telemetry.push(con.gpu.sample());
+
+        // mix this frame's audio
+        con.mixer.mute(con.gpu.turbo());
+        con.mixer.filter(con.gpu.filter());
+        con.mixer.advance(con.gpu.lines() + 1);
+        allocFrame(frame);
+    };
+    return 0;
+};
+
+// program entry
+int main(int argc, mt* argv) {
+    // parse options
+    Options opt;
+    if (!parseOptions(opt, argc, argv))
+        return 1;
+
+    // run regression suite in child processes
+    if (opt.suite)
+        return suite(argv[0], opt);
+    if (opt.bench)
+        return bench(argv[0], opt.bench, opt.frames);
+    if (!opt.rom)
+        return 0;
+    bool headless = opt.headless();
+    Console& con = primary;
+
+    // count allocations
+    allocHook();
+
+    // initialize sdl
+    if (SDL_Init(headless ? 0 : SDL_INIT_EVERYTHING)) {
+        printf(" - %s\n", SDL_GetError());
+        return 1;
+    };
+
+    // save file name
+    char filename[512];
+    sprintf(filename, "%s.sav", opt.rom);
+
+    // open rom
+    File file = loadFile(opt.rom);
+    if (!file.valid) {
+        printf(" - Failed to open %s\n", opt.rom);
+        return 2;
+    };
+
+    // init audio
+    if (headless) {
+        APU::setup(con.mixer, sampleRate);
+    } else if (!APU::create(con.mixer, sampleRate)) {
+        printf(" - %s\n", SDL_GetError());
+        return 3;
+    };
+
+    // try to open joystick
+    if (!headless && SDL_NumJoysticks() > 0) {
+        joy1 = SDL_JoystickOpen(0);
+        joy2 = SDL_JoystickOpen(1);
+        con.gpu.setJoystickUse(joy1 || joy2);
+    };
+
+    // init window
+    if (headless ? !con.gpu.createHeadless() : !con.gpu.create("X65", 320 * 2, 240 * 2)) {
+        printf(" - %s\n", SDL_GetError());
+        return 4;
+    };
+
+    // replay or record input with its seed
+    Uint64 seed = opt.seeded ? opt.seed : opt.fixed() ? 0 : Pacer::now();
+    if (opt.movie) {
+        if (!movie.play(opt.movie)) {
+            printf(" - Failed to open movie %s\n", opt.movie);
+            return 2;
+        };
+        seed = movie.seed();
+    };
+    if (opt.saveMovie)
+        movie.record(opt.saveMovie, seed);
+
+    // randomize memory state
+    powerOn(seed);
+
+    // parse rom
+    int errlevel = loadROM(file.data);
+    if (errlevel) {
+        // load error rom
+        File errc = loadFile(rootFile("error.x65"));
+        if (!errc.valid) {
+            printf(" - Failed to open error cart\n");
+            return 5;
+        };
+
+        int ferr = loadROM(errc.data);
+        if (ferr)
+            return ferr;
+
+        con.ram[0x00] = errlevel;
+    };
+
+    // load save file
+    if (con.sram) {
+        File save = loadFile(filename);
+        if (save.valid) {
+            if (save.data.size() == 0x10000) {
+                for (dt i = 0; i < save.data.size(); i++) {
+                    con.sav[i] = save.data[i];
+                };
+            } else {
+                printf(" - Save file should be 64K long\n");
+            };
+        };
+    };
+
+    // cpu mapping and initial reset
+    boot();
+
+    // emulated time independent of host speed
+    if (opt.budgeted())
+        con.gpu.budget(lineBudget);
+
+    // per-frame timing log
+    if (opt.telemetry && !telemetry.open(opt.telemetry)) {
+        printf(" - Failed to open %s\n", opt.telemetry);
+        return 2;
+    };
+
+    // record or verify without realtime loop
+    if (headless) {
+        int code;
+        if (opt.capture)
+            code = capture(opt.capture, opt.frames);
+        else if (opt.golden)
+            code = golden(opt.golden, opt.frames, opt.input, opt.record);
+        else
+            code = measure(opt.rom, opt.frames);
+        telemetry.close();
+        return code;
+    };
+
+    // map export region
+    if (opt.shared && !shared.open(opt.shared)) {
+        printf(" - Failed to create shared memory %s\n", opt.shared);
+        return 10;
+    };
+
+    // open session socket
+    if (opt.player && !netplay.open(opt.player, opt.port)) {
+        printf(" - Failed to open netplay port %d\n", opt.port + opt.player - 1);
+        return 9;
+    };
+
+    // start emulation
+    SDL_Thread* emu = SDL_CreateThread(emulate, "emulation", &opt);
+
+    // presentation loop, polls input often so budgeted frames latch fresh keys
+    int poll = opt.budgeted() ? 1 : 4;
+    while (con.gpu.running()) {
+        Uint64 mark = Pacer::now();
+        con.gpu.events(joy1, joy2);
+        con.gpu.update(joy1, joy2);
+        if (telemetry.active())
+            telemetry.host(PHASE_EVENTS, Pacer::now() - mark);
+        con.gpu.wait(poll);
+        con.gpu.present();
+        con.gpu.status();
+        telemetry.collect();
+    };
+    SDL_WaitThread(emu, null);
+    telemetry.collect();
+    telemetry.close();
+    con.gpu.pacer().report();
+    if (opt.player)
+        netplay.close();
+    shared.close();
+
+    // close joystick
+    if (joy1)
+        SDL_JoystickClose(joy1);
+    if (joy2)
+        SDL_JoystickClose(joy2);
+
+    // save SRAM
+    if (con.sram) {
+        File sf;
+        sf.name = filename;
+        sf.valid = true;
+        for (int i = 0; i < 0x10000; i++)
+            sf.data.push_back(con.sav[i]);
+        saveFile(sf);
+    };
+
+    // success
+    SDL_CloseAudio();
+    return 0;
+};
+#endif
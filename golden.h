@@ -0,0 +1,209 @@
+// -- golden frame regression -- //
+
+// scripted input, keys held from each listed frame on
+struct Script {
+    vec<dt> frames;
+    vec<dt> keys;
+    dt next = 0;
+    dt held = 0;
+
+    // keys for frame, called in frame order
+    dt at(dt frame) {
+        while (next < frames.size() && frames[next] <= frame)
+            held = keys[next++];
+        return held;
+    };
+};
+
+// parse "frame keys" lines with hex keys, # starts a comment
+bool loadScript(st path, Script& script) {
+    File file = loadFile(path);
+    if (!file.valid)
+        return false;
+
+    file.data.push_back(0);
+    char* text = (char*)file.data.data();
+    for (char* line = strtok(text, "\r\n"); line; line = strtok(null, "\r\n")) {
+        dt frame, keys;
+        if (line[0] == '#' || sscanf(line, "%u %x", &frame, &keys) != 2)
+            continue;
+        script.frames.push_back(frame);
+        script.keys.push_back(keys);
+    };
+    return true;
+};
+
+// 64-bit fnv-1a over words
+Uint64 hashData(const void* data, dt size, Uint64 hash = 0xCBF29CE484222325ull) {
+    const Uint8* bytes = (const Uint8*)data;
+    for (dt i = 0; i + 8 <= size; i += 8) {
+        Uint64 word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * 0x100000001B3ull;
+    };
+    for (dt i = size & ~7u; i < size; i++)
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    return hash;
+};
+
+// per frame state hashes
+struct Digest {
+    Uint64 video;
+    Uint64 memory;
+    Uint64 audio;
+};
+
+// run rom headless and check or record golden hashes
+int golden(st path, dt frames, st input, bool record) {
+    Script script;
+    if (input && !loadScript(input, script)) {
+        printf(" - Failed to open input script %s\n", input);
+        return 7;
+    };
+
+    // read expected hashes
+    vec<Digest> expect;
+    if (!record) {
+        FILE* fp = fopen(path, "r");
+        if (fp == null) {
+            printf(" - Failed to open golden file %s\n", path);
+            return 7;
+        };
+        dt frame;
+        unsigned long long video, memory, audio;
+        while (fscanf(fp, "%u %llx %llx %llx", &frame, &video, &memory, &audio) == 4) {
+            Digest d;
+            d.video = video;
+            d.memory = memory;
+            d.audio = audio;
+            expect.push_back(d);
+        };
+        fclose(fp);
+    };
+
+    // run frames and hash state
+    static Uint16 audio[captureSamples * 2];
+    vec<Digest> result;
+    for (dt frame = 0; frame < frames; frame++) {
+        console->gpu.input(script.at(frame));
+        runFrame();
+        console->mixer.advance(console->gpu.lines() + 1);
+
+        // hash framebuffer, ram and mixer output
+        Digest d;
+        SDL_Surface* sur = console->gpu.frame();
+        d.video = 0xCBF29CE484222325ull;
+        for (int y = 0; y < 240; y++)
+            d.video = hashData((Uint8*)sur->pixels + y * sur->pitch, 320 * 4, d.video);
+        d.memory = hashData(console->ram, sizeof(console->ram));
+        d.audio = hashData(audio, console->mixer.drain(audio, captureSamples) * 4);
+        logFrame();
+
+        // report first divergent frame
+        if (!record) {
+            if (frame >= expect.size()) {
+                printf(" - %s: golden file ends at frame %u\n", path, frame);
+                return 8;
+            };
+            st part = null;
+            if (d.video != expect[frame].video) part = "framebuffer";
+            else if (d.memory != expect[frame].memory) part = "ram";
+            else if (d.audio != expect[frame].audio) part = "audio";
+            if (part) {
+                printf(" - %s: frame %u diverges in %s\n", path, frame, part);
+                return 8;
+            };
+        };
+        result.push_back(d);
+    };
+
+    // save hashes
+    if (record) {
+        FILE* fp = fopen(path, "w");
+        if (fp == null) {
+            printf(" - Failed to write golden file %s\n", path);
+            return 7;
+        };
+        for (dt i = 0; i < result.size(); i++)
+            fprintf(fp, "%u %016llx %016llx %016llx\n", i, (unsigned long long)result[i].video, (unsigned long long)result[i].memory, (unsigned long long)result[i].audio);
+        fclose(fp);
+        printf(" - %s: recorded %u frames\n", path, frames);
+    } else {
+        printf(" - %s: passed %u frames\n", path, frames);
+    };
+    return 0;
+};
+
+// suite job list
+struct Suite {
+    vec<std::string> commands;
+    vec<int> results;
+    std::atomic<dt> next {0};
+};
+
+// suite worker thread
+int suiteWorker(void* data) {
+    Suite* suite = (Suite*)data;
+    while (true) {
+        dt job = suite->next++;
+        if (job >= suite->commands.size())
+            return 0;
+        suite->results[job] = system(suite->commands[job].c_str());
+    };
+};
+
+// run every rom in a list file in parallel child processes
+int suite(st self, Options& opt) {
+    File list = loadFile(opt.suite);
+    if (!list.valid) {
+        printf(" - Failed to open suite %s\n", opt.suite);
+        return 2;
+    };
+
+    // one rom path per line, golden and input files sit beside it
+    Suite jobs;
+    vec<std::string> roms;
+    list.data.push_back(0);
+    char* text = (char*)list.data.data();
+    for (char* line = strtok(text, "\r\n"); line; line = strtok(null, "\r\n")) {
+        if (line[0] == '#' || line[0] == 0)
+            continue;
+
+        std::string rom = line;
+        std::string cmd = "\"" + std::string(self) + "\" \"" + rom + "\" --golden \"" + rom + ".golden\"";
+        cmd += " --frames " + std::to_string(opt.frames);
+        if (loadFile((rom + ".input").c_str()).valid)
+            cmd += " --input \"" + rom + ".input\"";
+        if (opt.seeded)
+            cmd += " --seed " + std::to_string(opt.seed);
+        if (opt.record)
+            cmd += " --record";
+
+        // cmd.exe strips the outer quote pair
+        #ifdef _WIN32
+        cmd = "\"" + cmd + "\"";
+        #endif
+        roms.push_back(rom);
+        jobs.commands.push_back(cmd);
+    };
+    jobs.results.resize(jobs.commands.size(), -1);
+
+    // spread roms over cores
+    int count = opt.jobs > 0 ? opt.jobs : SDL_GetCPUCount();
+    vec<SDL_Thread*> threads;
+    for (int i = 0; i < count; i++)
+        threads.push_back(SDL_CreateThread(suiteWorker, "suite", &jobs));
+    for (SDL_Thread* t : threads)
+        SDL_WaitThread(t, null);
+
+    // summary
+    dt passed = 0;
+    for (dt i = 0; i < roms.size(); i++) {
+        if (jobs.results[i] == 0)
+            passed++;
+        else
+            printf(" - FAILED %s\n", roms[i].c_str());
+    };
+    printf(" - %u of %u roms passed\n", passed, dt(roms.size()));
+    return passed == roms.size() ? 0 : 8;
+};
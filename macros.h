@@ -1,22 +1,35 @@
-// -- macros -- //
-
-// set surface pixel color
-void SetPixel(SDL_Surface* surface, int x, int y, Uint8 data) {
-    Uint8* target = (Uint8*)surface->pixels;
-    target[surface->pitch * y + x] = data;
-};
-
-// convert layer coords to memory coords
-bt toRoom(int x, int y) {
-    return (x >= 40 ? 1 : 0) | (y >= 30 ? 2 : 0);
-};
-wt toIndex(int x, int y) {
-    return (y % 30) * 40 + (x % 40);
-};
-
-// mod fix
-int mod(int a, int b) {
-    if (a < 0)
-        return a % b + b;
-    return a % b;
-};
+// -- macros -- //
+
+// set surface pixel color
+void SetPixel(SDL_Surface* surface, int x, int y, Uint8 data) {
+    Uint8* target = (Uint8*)surface->pixels;
+    target[surface->pitch * y + x] = data;
+};
+
+// convert layer coords to memory coords
+bt toRoom(int x, int y) {
+    return (x >= 40 ? 1 : 0) | (y >= 30 ? 2 : 0);
+};
+wt toIndex(int x, int y) {
+    return (y % 30) * 40 + (x % 40);
+};
+
+// mod fix
+int mod(int a, int b) {
+    if (a < 0)
+        return a % b + b;
+    return a % b;
+};
+
+// seeded power-on randomness
+Uint64 randomState = 0;
+void seedRandom(Uint64 seed) {
+    randomState = seed;
+};
+dt nextRandom() {
+    // splitmix64
+    Uint64 z = (randomState += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (z ^ (z >> 31)) & 0xFFFFFFFF;
+};
@@ -0,0 +1,160 @@
+// -- input movies -- //
+
+// movie constants
+const Uint32 movieMagic = 0x4D353658;
+const Uint32 movieVersion = 1;
+const int movieHeader = 20;
+const int movieRecord = 7;
+
+// run of identical input frames
+struct Run {
+    wt count;
+    wt keys1;
+    wt keys2;
+    bt flags;
+};
+
+// input movie recorder and player
+class Movie {
+    public:
+    // start recording to file, written on close
+    void record(st path, Uint64 seed) {
+        m_path = path;
+        m_seed = seed;
+        m_recording = true;
+    };
+    // load movie for replay
+    bool play(st path) {
+        FILE* fp = fopen(path, "rb");
+        if (fp == null)
+            return false;
+
+        // check header
+        bt head[movieHeader];
+        if (fread(head, 1, movieHeader, fp) != movieHeader || read32(head) != movieMagic || read32(head + 4) != movieVersion) {
+            fclose(fp);
+            return false;
+        };
+        m_seed = read32(head + 8) | Uint64(read32(head + 12)) << 32;
+        m_frames = read32(head + 16);
+
+        // read runs
+        bt data[movieRecord];
+        while (fread(data, 1, movieRecord, fp) == movieRecord) {
+            Run run;
+            run.count = data[0] | data[1] << 8;
+            run.keys1 = data[2] | data[3] << 8;
+            run.keys2 = data[4] | data[5] << 8;
+            run.flags = data[6];
+            m_runs.push_back(run);
+        };
+        fclose(fp);
+        m_playing = true;
+        return true;
+    };
+
+    // replace live input while playing, record what was used
+    Input frame(Input live) {
+        Input in = live;
+        if (m_playing) {
+            if (m_run < m_runs.size()) {
+                Run& run = m_runs[m_run];
+                in.keys = run.keys1 | run.keys2 << 16;
+                in.reset = (run.flags & 1) && m_pos == 0;
+                if (++m_pos >= run.count) {
+                    m_run++;
+                    m_pos = 0;
+                };
+            } else {
+                // live input resumes after the last run
+                m_playing = false;
+                printf(" - Movie finished after %u frames\n", m_frames);
+            };
+        };
+        if (m_recording)
+            add(in);
+        return in;
+    };
+
+    // seed stored with movie
+    Uint64 seed() {
+        return m_seed;
+    };
+
+    // write recording
+    ~Movie () {
+        if (!m_recording)
+            return;
+
+        FILE* fp = fopen(m_path, "wb");
+        if (fp == null) {
+            printf(" - Failed to write movie %s\n", m_path);
+            return;
+        };
+
+        bt head[movieHeader];
+        write32(head, movieMagic);
+        write32(head + 4, movieVersion);
+        write32(head + 8, m_seed & 0xFFFFFFFF);
+        write32(head + 12, m_seed >> 32);
+        write32(head + 16, m_length);
+        fwrite(head, 1, movieHeader, fp);
+
+        for (Run& run : m_take) {
+            bt data[movieRecord] = {
+                bt(run.count & 0xFF), bt(run.count >> 8),
+                bt(run.keys1 & 0xFF), bt(run.keys1 >> 8),
+                bt(run.keys2 & 0xFF), bt(run.keys2 >> 8),
+                run.flags
+            };
+            fwrite(data, 1, movieRecord, fp);
+        };
+        fclose(fp);
+    };
+
+    private:
+    // extend last run or start a new one
+    void add(Input in) {
+        wt keys1 = in.keys & 0xFFFF;
+        wt keys2 = in.keys >> 16;
+        m_length++;
+
+        if (!in.reset && !m_take.empty()) {
+            Run& last = m_take.back();
+            if (last.keys1 == keys1 && last.keys2 == keys2 && last.count < 0xFFFF) {
+                last.count++;
+                return;
+            };
+        };
+        Run run;
+        run.count = 1;
+        run.keys1 = keys1;
+        run.keys2 = keys2;
+        run.flags = in.reset ? 1 : 0;
+        m_take.push_back(run);
+    };
+
+    // little endian fields
+    static Uint32 read32(bt* data) {
+        return data[0] | data[1] << 8 | data[2] << 16 | Uint32(data[3]) << 24;
+    };
+    static void write32(bt* data, Uint32 value) {
+        for (int i = 0; i < 4; i++)
+            data[i] = (value >> (i * 8)) & 0xFF;
+    };
+
+    st m_path = null;
+    Uint64 m_seed = 0;
+
+    // replay runs and position
+    bool m_playing = false;
+    vec<Run> m_runs;
+    dt m_frames = 0;
+    dt m_run = 0;
+    dt m_pos = 0;
+
+    // recorded runs
+    bool m_recording = false;
+    vec<Run> m_take;
+    dt m_length = 0;
+};
@@ -0,0 +1,318 @@
+// -- rollback netplay -- //
+
+// socket layer
+#ifdef _WIN32
+typedef SOCKET sock;
+#define closeSocket closesocket
+#else
+typedef int sock;
+const sock INVALID_SOCKET = -1;
+#define closeSocket ::close
+#endif
+
+// session constants
+const Uint32 netMagic = 0x4E353658;
+const int netHeader = 25;
+const int netInputs = 32;
+const int rollbackWindow = 8;
+const int inputHistory = 64;
+const int hashHistory = 64;
+const int helloInterval = 100;
+const int peerTimeout = 5000;
+const Uint64 syncDelay = 1000000;
+
+// exchanged input word, pad keys and a reset request
+const wt netKeys = 0x0FFF;
+const wt netReset = 0x8000;
+
+// state checksum
+struct Check {
+    dt frame;
+    Uint64 hash;
+    bool valid;
+};
+
+// hash emulated state that both peers must agree on
+Uint64 hashState(State& state) {
+    wt regs[8] = {state.cpu.a, state.cpu.b, state.cpu.x, state.cpu.y, state.cpu.i, state.cpu.p, state.cpu.s, state.cpu.l};
+    Uint64 hash = hashData(regs, sizeof(regs));
+    hash = hashData(state.ram, sizeof(state.ram), hash);
+    hash = hashData(state.banks, sizeof(state.banks), hash);
+    hash = hashData(state.video.layers, sizeof(state.video.layers), hash);
+    hash = hashData(state.video.sprites, sizeof(state.video.sprites), hash);
+    return hashData(state.video.argb, sizeof(state.video.argb), hash);
+};
+
+// two player session over udp loopback
+class Netplay {
+    public:
+    // bind own port, peer listens on the other one
+    bool open(int player, Uint16 port) {
+        #ifdef _WIN32
+        WSADATA wsa;
+        if (WSAStartup(MAKEWORD(2, 2), &wsa))
+            return false;
+        #endif
+        m_player = player;
+        m_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (m_sock == INVALID_SOCKET)
+            return false;
+
+        sockaddr_in local = {};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        local.sin_port = htons(port + player - 1);
+        m_peer = local;
+        m_peer.sin_port = htons(port + 2 - player);
+        return bind(m_sock, (sockaddr*)&local, sizeof(local)) == 0;
+    };
+
+    // greet peer until it answers
+    bool connect() {
+        printf(" - Waiting for player %d\n", 3 - m_player);
+        while (console->gpu.running()) {
+            send();
+            if (ready(helloInterval) && receive()) {
+                printf(" - Player %d connected\n", 3 - m_player);
+                m_heard = Pacer::now();
+                return true;
+            };
+        };
+        return false;
+    };
+
+    // run one frame of the session
+    void frame() {
+        // hold while the oldest unconfirmed frame would leave the window
+        receive();
+        while (m_frame >= m_known + rollbackWindow) {
+            send();
+            if (!console->gpu.running())
+                return;
+            if (ready(helloInterval) && receive())
+                continue;
+            if (Pacer::now() - m_heard > Uint64(peerTimeout) * 1000000) {
+                printf(" - Lost player %d at frame %u\n", 3 - m_player, m_frame);
+                console->gpu.quit();
+                return;
+            };
+        };
+        if (m_rollback < m_frame)
+            resimulate();
+
+        // stay level with the peer
+        if (m_frame > m_latest + 1)
+            console->gpu.pacer().delay(syncDelay);
+
+        // save state for this frame and check confirmed frames
+        saveState(m_states[m_frame % rollbackWindow]);
+        confirm();
+
+        // run on local and predicted remote input
+        console->gpu.start();
+        Input in = console->gpu.poll();
+        m_local[m_frame % inputHistory] = (in.keys & netKeys) | (in.reset ? netReset : 0);
+        runFrame(input(m_frame));
+        m_frame++;
+        send();
+    };
+
+    // close socket and report rollback cost
+    void close() {
+        if (m_sock != INVALID_SOCKET)
+            closeSocket(m_sock);
+        m_sock = INVALID_SOCKET;
+        #ifdef _WIN32
+        WSACleanup();
+        #endif
+
+        if (m_rollbacks == 0)
+            return;
+        double cost = double(m_resimTime) / 1000000.0 / m_resimFrames;
+        printf(" - Netplay: %u rollbacks, %u frames re-simulated, max depth %u, %.3f ms per frame\n", m_rollbacks, m_resimFrames, m_depth, cost);
+    };
+
+    private:
+    // inputs for frame, remote predicted from the last known one
+    Input input(dt frame) {
+        wt remote = 0;
+        if (frame < m_known)
+            remote = m_remote[frame % inputHistory];
+        else if (m_known > 0)
+            remote = m_remote[(m_known - 1) % inputHistory] & netKeys;
+        m_used[frame % inputHistory] = remote;
+
+        // a reset from either player applies on the same frame for both
+        Input in;
+        wt local = m_local[frame % inputHistory];
+        wt pad1 = m_player == 1 ? local : remote;
+        wt pad2 = m_player == 1 ? remote : local;
+        in.keys = (pad1 & netKeys) | (pad2 & netKeys) << 16;
+        in.reset = (local | remote) & netReset;
+        return in;
+    };
+
+    // rewind to first mispredicted frame and replay it without audio or drawing
+    void resimulate() {
+        Uint64 start = Pacer::now();
+        dt depth = m_frame - m_rollback;
+        loadState(m_states[m_rollback % rollbackWindow]);
+
+        console->mixer.discard(true);
+        console->quiet = true;
+        for (dt frame = m_rollback; frame < m_frame; frame++) {
+            if (frame > m_rollback)
+                saveState(m_states[frame % rollbackWindow]);
+            console->gpu.ahead(false);
+            runFrame(input(frame));
+        };
+        console->mixer.discard(false);
+        console->quiet = false;
+
+        m_rollback = ~0u;
+        m_rollbacks++;
+        m_resimFrames += depth;
+        m_resimTime += Pacer::now() - start;
+        if (depth > m_depth)
+            m_depth = depth;
+    };
+
+    // hash every state whose inputs are all known
+    void confirm() {
+        dt frame = m_known < m_frame ? m_known : m_frame;
+        for (; m_checked <= frame; m_checked++) {
+            Check& mine = m_hashes[m_checked % hashHistory];
+            mine.frame = m_checked;
+            mine.hash = hashState(m_states[m_checked % rollbackWindow]);
+            mine.valid = true;
+            compare(m_theirs[m_checked % hashHistory], mine);
+            m_mine = mine;
+        };
+    };
+    void compare(Check& theirs, Check& mine) {
+        if (!theirs.valid || !mine.valid || theirs.frame != mine.frame || m_desync)
+            return;
+        if (theirs.hash != mine.hash) {
+            printf(" - Desync at frame %u\n", mine.frame);
+            m_desync = true;
+            console->gpu.quit();
+        };
+    };
+
+    // send unacknowledged inputs and latest checksum
+    void send() {
+        bt data[netHeader + netInputs * 2];
+        dt first = m_acked;
+        dt count = m_frame - first < dt(netInputs) ? m_frame - first : netInputs;
+
+        write32(data, netMagic);
+        write32(data + 4, first);
+        data[8] = count;
+        write32(data + 9, m_known);
+        write32(data + 13, m_mine.valid ? m_mine.frame : ~0u);
+        write32(data + 17, m_mine.hash & 0xFFFFFFFF);
+        write32(data + 21, m_mine.hash >> 32);
+        for (dt i = 0; i < count; i++) {
+            wt keys = m_local[(first + i) % inputHistory];
+            data[netHeader + i * 2 + 0] = keys & 0xFF;
+            data[netHeader + i * 2 + 1] = keys >> 8;
+        };
+        sendto(m_sock, (const char*)data, netHeader + count * 2, 0, (sockaddr*)&m_peer, sizeof(m_peer));
+    };
+
+    // drain queued packets, true when any arrived
+    bool receive() {
+        bool any = false;
+        bt data[netHeader + netInputs * 2];
+        while (ready(0)) {
+            int size = recvfrom(m_sock, (char*)data, sizeof(data), 0, null, null);
+            if (size < netHeader || read32(data) != netMagic || size < netHeader + data[8] * 2)
+                continue;
+            any = true;
+            m_heard = Pacer::now();
+
+            // take inputs in order, later frames wait for a resend
+            dt first = read32(data + 4);
+            dt count = data[8];
+            for (dt i = 0; i < count; i++) {
+                dt frame = first + i;
+                if (frame != m_known)
+                    continue;
+                wt keys = data[netHeader + i * 2] | data[netHeader + i * 2 + 1] << 8;
+                m_remote[frame % inputHistory] = keys;
+                if (frame < m_frame && m_used[frame % inputHistory] != keys && frame < m_rollback)
+                    m_rollback = frame;
+                m_known++;
+            };
+            if (count && first + count - 1 > m_latest)
+                m_latest = first + count - 1;
+
+            // peer progress and checksum
+            dt acked = read32(data + 9);
+            if (acked > m_acked)
+                m_acked = acked;
+            Check theirs;
+            theirs.frame = read32(data + 13);
+            theirs.hash = read32(data + 17) | Uint64(read32(data + 21)) << 32;
+            theirs.valid = theirs.frame != ~0u;
+            if (theirs.valid) {
+                m_theirs[theirs.frame % hashHistory] = theirs;
+                compare(theirs, m_hashes[theirs.frame % hashHistory]);
+            };
+        };
+        return any;
+    };
+
+    // wait for a packet up to ms
+    bool ready(int ms) {
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(m_sock, &set);
+        timeval tv;
+        tv.tv_sec = ms / 1000;
+        tv.tv_usec = (ms % 1000) * 1000;
+        return select(m_sock + 1, &set, null, null, &tv) > 0;
+    };
+
+    // little endian fields
+    static Uint32 read32(bt* data) {
+        return data[0] | data[1] << 8 | data[2] << 16 | Uint32(data[3]) << 24;
+    };
+    static void write32(bt* data, Uint32 value) {
+        for (int i = 0; i < 4; i++)
+            data[i] = (value >> (i * 8)) & 0xFF;
+    };
+
+    // connection
+    sock m_sock = INVALID_SOCKET;
+    sockaddr_in m_peer;
+    int m_player = 1;
+    Uint64 m_heard = 0;
+
+    // frame progress
+    dt m_frame = 0;
+    dt m_known = 0;
+    dt m_acked = 0;
+    dt m_latest = 0;
+    dt m_rollback = ~0u;
+
+    // input and state history
+    wt m_local[inputHistory];
+    wt m_remote[inputHistory];
+    wt m_used[inputHistory];
+    State m_states[rollbackWindow];
+
+    // desync detection
+    Check m_mine = {0, 0, false};
+    Check m_hashes[hashHistory] = {};
+    Check m_theirs[hashHistory] = {};
+    dt m_checked = 0;
+    bool m_desync = false;
+
+    // rollback statistics
+    dt m_rollbacks = 0;
+    dt m_resimFrames = 0;
+    dt m_depth = 0;
+    Uint64 m_resimTime = 0;
+};
+Netplay netplay;
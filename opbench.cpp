@@ -0,0 +1,223 @@
+// -- opcode microbenchmark -- //
+
+// include libraries
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+// include cpu
+#include "x65-cpu.h"
+using namespace x65;
+
+// sequence layout
+const wt codeStart = 0x8080;
+const wt dataAddr = 0x0100;
+const bt zeroAddr = 0x10;
+const int copies = 1024;
+const int rounds = 5;
+
+// ram-only memory map
+bt memory[0x10000];
+void set(wt addr, bt data) {
+    memory[addr] = data;
+};
+bt get(wt addr) {
+    return memory[addr];
+};
+
+// handler names by function
+struct Named {
+    opcf handler;
+    const char* name;
+};
+Named handlers[] {
+    {NOP, "NOP"}, {ERR, "ERR"}, {WAI, "WAI"}, {JAM, "JAM"}, {PHP, "PHP"}, {PLP, "PLP"}, {PHA, "PHA"}, {PLA, "PLA"},
+    {PHB, "PHB"}, {PLB, "PLB"}, {PHX, "PHX"}, {PLX, "PLX"}, {PHY, "PHY"}, {PLY, "PLY"}, {PHD, "PHD"}, {PLD, "PLD"},
+    {TAB, "TAB"}, {TAX, "TAX"}, {TAY, "TAY"}, {TBA, "TBA"}, {TXA, "TXA"}, {TXY, "TXY"}, {TYA, "TYA"}, {TYX, "TYX"},
+    {TXS, "TXS"}, {TSX, "TSX"}, {THD, "THD"}, {TDH, "TDH"}, {CLC, "CLC"}, {SEC, "SEC"}, {CLI, "CLI"}, {SEI, "SEI"},
+    {CLF, "CLF"}, {SEF, "SEF"}, {CLV, "CLV"}, {INX, "INX"}, {DEX, "DEX"}, {INY, "INY"}, {DEY, "DEY"}, {INS, "INS"},
+    {DES, "DES"}, {ASL, "ASL"}, {LSR, "LSR"}, {ROL, "ROL"}, {ROR, "ROR"}, {CMP, "CMP"}, {CPX, "CPX"}, {CPY, "CPY"},
+    {CMD, "CMD"}, {AND, "AND"}, {ORA, "ORA"}, {XOR, "XOR"}, {LTA, "LTA"}, {LTB, "LTB"}, {LTX, "LTX"}, {LTY, "LTY"},
+    {LTD, "LTD"}, {ADC, "ADC"}, {SBC, "SBC"}, {STZ, "STZ"}, {STA, "STA"}, {STB, "STB"}, {STX, "STX"}, {STY, "STY"},
+    {STD, "STD"}, {BPL, "BPL"}, {BMI, "BMI"}, {BVC, "BVC"}, {BVS, "BVS"}, {BCC, "BCC"}, {BCS, "BCS"}, {BNE, "BNE"},
+    {BEQ, "BEQ"}, {BRA, "BRA"}, {INC, "INC"}, {DEC, "DEC"}, {BIT, "BIT"}, {MUL, "MUL"}, {DIV, "DIV"}, {MOD, "MOD"},
+    {LTV, "LTV"}, {JMP, "JMP"}, {JSR, "JSR"}, {RTS, "RTS"}, {RTI, "RTI"}, {SEP, "SEP"}, {REP, "REP"}, {TSB, "TSB"},
+    {TRB, "TRB"}, {PEA, "PEA"}, {BRK, "BRK"}
+};
+const char* modeNames[] = {"NOT", "IMP", "ACC", "BUF", "IMM", "DIM", "REL", "DIR", "DRX", "DRY", "ZPG", "ZPX", "ZPY", "IND"};
+
+// mnemonic of opcode handler
+const char* opcodeName(bt opcode) {
+    for (Named& n : handlers) {
+        if (n.handler == opcodeTable[opcode])
+            return n.name;
+    };
+    return "???";
+};
+
+// operand bytes of addressing mode
+int operandSize(Mode mode) {
+    switch (mode) {
+        case IMM: case REL: case ZPG: case ZPX: case ZPY: return 1;
+        case DIM: case DIR: case DRX: case DRY: return 2;
+        default: return 0;
+    };
+};
+
+// host counters, unavailable outside linux or without permission
+class Counters {
+    public:
+    bool open() {
+        #ifdef __linux__
+        m_branch = event(PERF_COUNT_HW_BRANCH_MISSES, -1);
+        if (m_branch >= 0)
+            m_cache = event(PERF_COUNT_HW_CACHE_MISSES, m_branch);
+        #endif
+        return m_branch >= 0 && m_cache >= 0;
+    };
+    void start() {
+        #ifdef __linux__
+        if (m_branch < 0) return;
+        ioctl(m_branch, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_branch, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        #endif
+    };
+    void stop(long long& branch, long long& cache) {
+        branch = cache = -1;
+        #ifdef __linux__
+        if (m_branch < 0) return;
+        ioctl(m_branch, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        if (read(m_branch, &branch, sizeof(branch)) != sizeof(branch)) branch = -1;
+        if (m_cache >= 0 && read(m_cache, &cache, sizeof(cache)) != sizeof(cache)) cache = -1;
+        #endif
+    };
+
+    private:
+    #ifdef __linux__
+    int event(unsigned long long config, int group) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+    };
+    #endif
+    int m_branch = -1;
+    int m_cache = -1;
+};
+
+// fill memory with copies of one opcode looping back to the start
+void generate(bt opcode) {
+    Mode mode = opcodeMode[opcode];
+    int size = operandSize(mode);
+
+    // data, stack returns and vectors all point into the sequence
+    memset(memory, 0x11, sizeof(memory));
+    memset(memory + 0x1000, codeStart & 0xFF, 0x1000);
+    for (wt v = 0xFFFA; v != 0; v += 2) {
+        memory[v] = codeStart & 0xFF;
+        memory[v + 1] = codeStart >> 8;
+    };
+
+    wt pos = codeStart;
+    for (int i = 0; i < copies; i++) {
+        wt next = pos + 1 + size;
+        memory[pos] = opcode;
+
+        // branches fall through, jumps and calls go to the next copy
+        wt operand = dataAddr;
+        if (mode == REL) operand = 0;
+        else if (mode == IMM || mode == ZPG || mode == ZPX || mode == ZPY) operand = zeroAddr;
+        else if (mode == DIR && opcodeTable[opcode] == JMP) operand = next;
+        else if (mode == DIR && opcodeTable[opcode] == JSR) operand = next;
+        if (size >= 1) memory[pos + 1] = operand & 0xFF;
+        if (size == 2) memory[pos + 2] = operand >> 8;
+        pos = next;
+    };
+
+    // jmp back to start
+    memory[pos + 0] = 0xDF;
+    memory[pos + 1] = codeStart & 0xFF;
+    memory[pos + 2] = codeStart >> 8;
+};
+
+// cpu at sequence start with small indexes and nonzero divisor
+void reset(CPU& cpu, bt opcode) {
+    cpu = CPU();
+    cpu.set = &set;
+    cpu.get = &get;
+    cpu.a = 0x1234;
+    cpu.b = 0x0003;
+    cpu.x = opcodeMode[opcode] == IND ? codeStart : 0x0010;
+    cpu.y = 0x0020;
+    cpu.p = 0;
+    cpu.i = codeStart;
+};
+
+// execute count instructions without the halt and wait check of tick
+void run(CPU& cpu, long long count) {
+    for (long long n = 0; n < count; n++) {
+        bt opcode = nextByte(cpu);
+        opcodeTable[opcode](cpu, opcodeMode[opcode]);
+    };
+};
+
+// program entry
+int main(int argc, char** argv) {
+    long long count = argc > 1 ? atoll(argv[1]) : 1000000;
+    if (count <= 0) {
+        printf(" - Usage: opbench [instructions per opcode]\n");
+        return 1;
+    };
+
+    // counters are optional, columns stay empty without them
+    Counters counters;
+    if (!counters.open())
+        fprintf(stderr, " - Host counters unavailable, reporting time only\n");
+
+    CPU cpu;
+    printf("opcode,name,mode,ns_per_instruction,branch_misses_per_1k,cache_misses_per_1k\n");
+    for (int op = 0; op < 256; op++) {
+        generate(op);
+
+        // best of several rounds after a warm up pass
+        double best = 0;
+        long long branch = -1, cache = -1;
+        reset(cpu, op);
+        run(cpu, count / 10 + 1);
+        for (int r = 0; r < rounds; r++) {
+            reset(cpu, op);
+            long long b, c;
+            counters.start();
+            auto start = std::chrono::steady_clock::now();
+            run(cpu, count);
+            auto end = std::chrono::steady_clock::now();
+            counters.stop(b, c);
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count() / count;
+            if (r == 0 || ns < best) {
+                best = ns;
+                branch = b;
+                cache = c;
+            };
+        };
+
+        printf("%02X,%s,%s,%.2f,", op, opcodeName(op), modeNames[opcodeMode[op]], best);
+        if (branch >= 0) printf("%.3f", branch * 1000.0 / count);
+        printf(",");
+        if (cache >= 0) printf("%.3f", cache * 1000.0 / count);
+        printf("\n");
+    };
+    return 0;
+};
@@ -0,0 +1,105 @@
+// -- command line options -- //
+
+// run-ahead limit
+const dt aheadLimit = 8;
+
+// option values
+struct Options {
+    st rom = null;
+    st capture = null;
+    st golden = null;
+    st input = null;
+    st suite = null;
+    st movie = null;
+    st saveMovie = null;
+    st shared = null;
+    st telemetry = null;
+    st bench = null;
+    dt frames = 600;
+    dt ahead = 0;
+    int jobs = 0;
+    int player = 0;
+    int port = 6565;
+    bool record = false;
+    Uint64 seed = 0;
+    bool seeded = false;
+    bool deterministic = false;
+    bool late = false;
+    bool measure = false;
+
+    // runs without window or audio device
+    bool headless() {
+        return capture || golden || measure;
+    };
+    // runs on fixed seed and instruction budget
+    bool fixed() {
+        return deterministic || headless() || movie || saveMovie || player;
+    };
+    // runs lines on instruction budget
+    bool budgeted() {
+        return fixed() || late || ahead;
+    };
+};
+
+// parse command line
+bool parseOptions(Options& opt, int argc, mt* argv) {
+    for (int i = 1; i < argc; i++) {
+        st arg = argv[i];
+        bool more = i + 1 < argc;
+
+        if (!strcmp(arg, "--capture") && more) {
+            opt.capture = argv[++i];
+        } else if (!strcmp(arg, "--golden") && more) {
+            opt.golden = argv[++i];
+        } else if (!strcmp(arg, "--input") && more) {
+            opt.input = argv[++i];
+        } else if (!strcmp(arg, "--movie") && more) {
+            opt.movie = argv[++i];
+        } else if (!strcmp(arg, "--save-movie") && more) {
+            opt.saveMovie = argv[++i];
+        } else if (!strcmp(arg, "--shm") && more) {
+            opt.shared = argv[++i];
+        } else if (!strcmp(arg, "--telemetry") && more) {
+            opt.telemetry = argv[++i];
+        } else if (!strcmp(arg, "--bench") && more) {
+            opt.bench = argv[++i];
+        } else if (!strcmp(arg, "--suite") && more) {
+            opt.suite = argv[++i];
+        } else if (!strcmp(arg, "--frames") && more) {
+            opt.frames = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--jobs") && more) {
+            opt.jobs = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--seed") && more) {
+            opt.seed = strtoull(argv[++i], null, 0);
+            opt.seeded = true;
+        } else if (!strcmp(arg, "--runahead") && more) {
+            opt.ahead = atoi(argv[++i]);
+            if (opt.ahead > aheadLimit)
+                opt.ahead = aheadLimit;
+        } else if (!strcmp(arg, "--netplay") && more) {
+            opt.player = atoi(argv[++i]) == 2 ? 2 : 1;
+        } else if (!strcmp(arg, "--port") && more) {
+            opt.port = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--late")) {
+            opt.late = true;
+        } else if (!strcmp(arg, "--deterministic")) {
+            opt.deterministic = true;
+        } else if (!strcmp(arg, "--measure")) {
+            opt.measure = true;
+        } else if (!strcmp(arg, "--record")) {
+            opt.record = true;
+        } else if (arg[0] != '-' && !opt.rom) {
+            opt.rom = arg;
+        } else {
+            printf(" - Unknown option %s\n", arg);
+            return false;
+        };
+    };
+
+    // netplay input does not pass through movies
+    if (opt.player && (opt.movie || opt.saveMovie)) {
+        printf(" - Movies cannot be played or recorded with --netplay\n");
+        return false;
+    };
+    return true;
+};
@@ -0,0 +1,97 @@
+// -- frame pacing -- //
+
+// pacing constants
+const Uint64 frameRate = 60;
+const Uint64 spinMargin = 2000000;
+const Uint64 resyncFrames = 4;
+const Uint64 lateMargin = 1000000;
+
+// frame pacer
+class Pacer {
+    public:
+    // monotonic clock in nanoseconds
+    static Uint64 now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    };
+
+    // begin next frame
+    void begin(bool paced) {
+        Uint64 time = now();
+
+        // resync when unpaced or too far behind
+        if (!paced || !m_paced || time > deadline(m_frame + resyncFrames)) {
+            m_origin = time;
+            m_frame = 0;
+        } else {
+            m_frame++;
+            if (time > deadline(m_frame) + lateMargin)
+                m_late++;
+
+            // frame interval statistics
+            double delta = double(time - m_last) / 1000000.0;
+            m_sum += delta;
+            m_sqr += delta * delta;
+            if (m_count == 0 || delta < m_min) m_min = delta;
+            if (m_count == 0 || delta > m_max) m_max = delta;
+            m_count++;
+        };
+        m_paced = paced;
+        m_last = time;
+    };
+
+    // get frame deadline
+    Uint64 deadline(Uint64 frame) {
+        return m_origin + frame * 1000000000ull / frameRate;
+    };
+    // get time at part of current frame
+    Uint64 at(int part, int parts) {
+        Uint64 start = deadline(m_frame);
+        return start + (deadline(m_frame + 1) - start) * part / parts;
+    };
+    // get current frame end
+    Uint64 end() {
+        return deadline(m_frame + 1);
+    };
+    // push schedule back
+    void delay(Uint64 time) {
+        m_origin += time;
+    };
+
+    // sleep then spin until time
+    void wait(Uint64 until) {
+        while (true) {
+            Uint64 time = now();
+            if (time >= until)
+                return;
+
+            // sleep for most of the wait
+            if (until - time > spinMargin + 1000000)
+                SDL_Delay((until - time - spinMargin) / 1000000);
+        };
+    };
+
+    // print jitter statistics
+    void report() {
+        if (m_count == 0)
+            return;
+
+        double mean = m_sum / m_count;
+        double dev = sqrt(fmax(m_sqr / m_count - mean * mean, 0.0));
+        printf(" - Frame time: mean %.3f ms, jitter %.3f ms, min %.3f ms, max %.3f ms, %u late\n", mean, dev, m_min, m_max, m_late);
+    };
+
+    private:
+    // schedule
+    Uint64 m_origin = 0;
+    Uint64 m_frame = 0;
+    Uint64 m_last = 0;
+    bool m_paced = false;
+
+    // statistics
+    dt m_count = 0;
+    dt m_late = 0;
+    double m_sum = 0.0;
+    double m_sqr = 0.0;
+    double m_min = 0.0;
+    double m_max = 0.0;
+};
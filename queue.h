@@ -0,0 +1,43 @@
+// -- lock-free queue -- //
+
+// single producer, single consumer ring buffer
+template <typename T, dt size>
+class Queue {
+    public:
+    // add item, fails when full
+    bool push(const T& item) {
+        dt head = m_head.load(std::memory_order_relaxed);
+        dt next = (head + 1) % size;
+        if (next == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        m_items[head] = item;
+        m_head.store(next, std::memory_order_release);
+        return true;
+    };
+    // read oldest item, fails when empty
+    bool peek(T& item) {
+        dt tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire))
+            return false;
+
+        item = m_items[tail];
+        return true;
+    };
+    // number of queued items
+    dt fill() {
+        dt head = m_head.load(std::memory_order_acquire);
+        dt tail = m_tail.load(std::memory_order_acquire);
+        return (head + size - tail) % size;
+    };
+    // drop oldest item
+    void pop() {
+        dt tail = m_tail.load(std::memory_order_relaxed);
+        m_tail.store((tail + 1) % size, std::memory_order_release);
+    };
+
+    private:
+    T m_items[size];
+    alignas(64) std::atomic<dt> m_head {0};
+    alignas(64) std::atomic<dt> m_tail {0};
+};
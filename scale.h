@@ -0,0 +1,172 @@
+// -- frame scaler -- //
+
+// row expander function
+typedef void (*expandf)(const Uint32* src, Uint32* dst, int width, int factor);
+
+// scalar row expander
+void expandScalar(const Uint32* src, Uint32* dst, int width, int factor) {
+    for (int x = 0; x < width; x++) {
+        for (int i = 0; i < factor; i++)
+            *dst++ = src[x];
+    };
+};
+
+#ifdef X65_SIMD
+// sse2 row expander
+TARGET("sse2") void expandSSE2(const Uint32* src, Uint32* dst, int width, int factor) {
+    int x = 0;
+    switch (factor) {
+        case 1:
+        memcpy(dst, src, width * 4);
+        return;
+        case 2:
+        for (; x + 4 <= width; x += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+            _mm_storeu_si128((__m128i*)(dst + x * 2 + 0), _mm_unpacklo_epi32(v, v));
+            _mm_storeu_si128((__m128i*)(dst + x * 2 + 4), _mm_unpackhi_epi32(v, v));
+        };
+        break;
+        case 3:
+        for (; x + 4 <= width; x += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+            _mm_storeu_si128((__m128i*)(dst + x * 3 + 0), _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 0, 0)));
+            _mm_storeu_si128((__m128i*)(dst + x * 3 + 4), _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 1, 1)));
+            _mm_storeu_si128((__m128i*)(dst + x * 3 + 8), _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 2)));
+        };
+        break;
+        case 4:
+        for (; x + 4 <= width; x += 4) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + x));
+            _mm_storeu_si128((__m128i*)(dst + x * 4 + 0), _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 0, 0, 0)));
+            _mm_storeu_si128((__m128i*)(dst + x * 4 + 4), _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 1, 1)));
+            _mm_storeu_si128((__m128i*)(dst + x * 4 + 8), _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 2, 2)));
+            _mm_storeu_si128((__m128i*)(dst + x * 4 + 12), _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3)));
+        };
+        break;
+    };
+
+    // leftover pixels
+    expandScalar(src + x, dst + x * factor, width - x, factor);
+};
+#endif
+
+// select row expander for host cpu
+expandf expander() {
+    #ifdef X65_SIMD
+    if (SDL_HasSSE2())
+        return expandSSE2;
+    #endif
+    return expandScalar;
+};
+
+// get pixel row
+inline Uint32* pixelRow(void* pixels, int pitch, int y) {
+    return (Uint32*)((Uint8*)pixels + pitch * y);
+};
+
+// nearest neighbor scaler
+void scaleNearest(expandf expand, void* src, int spitch, void* dst, int dpitch, int width, int height, int factor) {
+    for (int y = 0; y < height; y++) {
+        Uint32* row = pixelRow(dst, dpitch, y * factor);
+        expand(pixelRow(src, spitch, y), row, width, factor);
+
+        // duplicate expanded row
+        for (int i = 1; i < factor; i++)
+            memcpy(pixelRow(dst, dpitch, y * factor + i), row, width * factor * 4);
+    };
+};
+
+// advmame2x scaler
+void scale2x(void* src, int spitch, void* dst, int dpitch, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        Uint32* up = pixelRow(src, spitch, y > 0 ? y - 1 : y);
+        Uint32* mid = pixelRow(src, spitch, y);
+        Uint32* down = pixelRow(src, spitch, y < height - 1 ? y + 1 : y);
+        Uint32* out0 = pixelRow(dst, dpitch, y * 2 + 0);
+        Uint32* out1 = pixelRow(dst, dpitch, y * 2 + 1);
+
+        for (int x = 0; x < width; x++) {
+            Uint32 b = up[x];
+            Uint32 d = mid[x > 0 ? x - 1 : x];
+            Uint32 e = mid[x];
+            Uint32 f = mid[x < width - 1 ? x + 1 : x];
+            Uint32 h = down[x];
+
+            if (b != h && d != f) {
+                out0[x * 2 + 0] = d == b ? d : e;
+                out0[x * 2 + 1] = b == f ? f : e;
+                out1[x * 2 + 0] = d == h ? d : e;
+                out1[x * 2 + 1] = h == f ? f : e;
+            } else {
+                out0[x * 2 + 0] = e;
+                out0[x * 2 + 1] = e;
+                out1[x * 2 + 0] = e;
+                out1[x * 2 + 1] = e;
+            };
+        };
+    };
+};
+
+// advmame3x scaler
+void scale3x(void* src, int spitch, void* dst, int dpitch, int width, int height) {
+    for (int y = 0; y < height; y++) {
+        Uint32* up = pixelRow(src, spitch, y > 0 ? y - 1 : y);
+        Uint32* mid = pixelRow(src, spitch, y);
+        Uint32* down = pixelRow(src, spitch, y < height - 1 ? y + 1 : y);
+        Uint32* out0 = pixelRow(dst, dpitch, y * 3 + 0);
+        Uint32* out1 = pixelRow(dst, dpitch, y * 3 + 1);
+        Uint32* out2 = pixelRow(dst, dpitch, y * 3 + 2);
+
+        for (int x = 0; x < width; x++) {
+            int l = x > 0 ? x - 1 : x;
+            int r = x < width - 1 ? x + 1 : x;
+            Uint32 a = up[l], b = up[x], c = up[r];
+            Uint32 d = mid[l], e = mid[x], f = mid[r];
+            Uint32 g = down[l], h = down[x], i = down[r];
+
+            if (b != h && d != f) {
+                out0[x * 3 + 0] = d == b ? d : e;
+                out0[x * 3 + 1] = (d == b && e != c) || (b == f && e != a) ? b : e;
+                out0[x * 3 + 2] = b == f ? f : e;
+                out1[x * 3 + 0] = (d == b && e != g) || (d == h && e != a) ? d : e;
+                out1[x * 3 + 1] = e;
+                out1[x * 3 + 2] = (b == f && e != i) || (h == f && e != c) ? f : e;
+                out2[x * 3 + 0] = d == h ? d : e;
+                out2[x * 3 + 1] = (d == h && e != i) || (h == f && e != g) ? h : e;
+                out2[x * 3 + 2] = h == f ? f : e;
+            } else {
+                for (int n = 0; n < 3; n++) {
+                    out0[x * 3 + n] = e;
+                    out1[x * 3 + n] = e;
+                    out2[x * 3 + n] = e;
+                };
+            };
+        };
+    };
+};
+
+// scale frame by integer factor
+void scaleFrame(expandf expand, bool smooth, SDL_Surface* src, void* dst, int dpitch, int factor, Uint32* temp) {
+    int w = src->w;
+    int h = src->h;
+
+    // plain pixel scaling
+    if (!smooth || factor == 1) {
+        scaleNearest(expand, src->pixels, src->pitch, dst, dpitch, w, h, factor);
+        return;
+    };
+
+    // edge smoothing filters
+    switch (factor) {
+        case 2:
+        scale2x(src->pixels, src->pitch, dst, dpitch, w, h);
+        break;
+        case 3:
+        scale3x(src->pixels, src->pitch, dst, dpitch, w, h);
+        break;
+        case 4:
+        scale2x(src->pixels, src->pitch, temp, w * 8, w, h);
+        scale2x(temp, w * 8, dst, dpitch, w * 2, h * 2);
+        break;
+    };
+};
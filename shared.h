@@ -0,0 +1,93 @@
+// -- shared memory export -- //
+
+// region header values
+const Uint32 sharedMagic = 0x53353658;
+const Uint32 sharedVersion = 1;
+
+// region mapped by other processes
+struct Region {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 width;
+    Uint32 height;
+
+    // odd while a frame is being written
+    std::atomic<Uint32> sequence;
+    Uint32 frame;
+    Uint32 pixels[320 * 240];
+    bt ram[0x4000];
+};
+
+// latest frame and ram published under a seqlock
+class Shared {
+    public:
+    // create named region
+    bool open(st name) {
+        #ifdef _WIN32
+        m_map = CreateFileMappingA(INVALID_HANDLE_VALUE, null, PAGE_READWRITE, 0, sizeof(Region), name);
+        if (m_map == null)
+            return false;
+        m_region = (Region*)MapViewOfFile(m_map, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Region));
+        #else
+        m_name = std::string("/") + name;
+        int fd = shm_open(m_name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0)
+            return false;
+        if (ftruncate(fd, sizeof(Region)) == 0) {
+            void* view = mmap(null, sizeof(Region), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            m_region = view == MAP_FAILED ? null : (Region*)view;
+        };
+        ::close(fd);
+        if (m_region == null)
+            shm_unlink(m_name.c_str());
+        #endif
+        if (m_region == null)
+            return false;
+
+        m_region->magic = sharedMagic;
+        m_region->version = sharedVersion;
+        m_region->width = 320;
+        m_region->height = 240;
+        m_region->sequence.store(0, std::memory_order_release);
+        return true;
+    };
+
+    // publish frame, readers retry while the sequence is odd or changed
+    void write(dt frame, SDL_Surface* pixels, bt* ram) {
+        Uint32 seq = m_region->sequence.load(std::memory_order_relaxed);
+        m_region->sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        m_region->frame = frame;
+        if (pixels) {
+            for (int y = 0; y < 240; y++)
+                memcpy(m_region->pixels + y * 320, (Uint8*)pixels->pixels + y * pixels->pitch, 320 * 4);
+        };
+        memcpy(m_region->ram, ram, sizeof(m_region->ram));
+
+        m_region->sequence.store(seq + 2, std::memory_order_release);
+    };
+
+    // unmap region
+    void close() {
+        if (m_region == null)
+            return;
+        #ifdef _WIN32
+        UnmapViewOfFile(m_region);
+        CloseHandle(m_map);
+        #else
+        munmap(m_region, sizeof(Region));
+        shm_unlink(m_name.c_str());
+        #endif
+        m_region = null;
+    };
+
+    private:
+    Region* m_region = null;
+    #ifdef _WIN32
+    HANDLE m_map = null;
+    #else
+    std::string m_name;
+    #endif
+};
+Shared shared;
@@ -0,0 +1,59 @@
+// -- save states -- //
+
+// machine state
+struct State {
+    CPU cpu;
+    bt ram[0x4000];
+    bt sav[0x10000];
+    bt banks[8];
+    bt sbank;
+    bt bufbyte;
+    Snapshot video;
+};
+
+// copy machine state
+void saveState(State& state) {
+    state.cpu = console->cpu;
+    memcpy(state.ram, console->ram, sizeof(console->ram));
+    if (console->sram)
+        memcpy(state.sav, console->sav, sizeof(console->sav));
+    memcpy(state.banks, console->banks, sizeof(console->banks));
+    state.sbank = console->sbank;
+    state.bufbyte = console->bufbyte;
+    console->gpu.save(state.video);
+};
+void loadState(State& state) {
+    console->cpu = state.cpu;
+    memcpy(console->ram, state.ram, sizeof(console->ram));
+    if (console->sram)
+        memcpy(console->sav, state.sav, sizeof(console->sav));
+    memcpy(console->banks, state.banks, sizeof(console->banks));
+    console->sbank = state.sbank;
+    console->bufbyte = state.bufbyte;
+    console->gpu.load(state.video);
+};
+
+// run real frame unseen, show a frame predicted on the same input, then rewind
+void runAhead(dt frames) {
+    static State state;
+    console->gpu.start();
+    Input in = movie.frame(console->gpu.poll());
+    bool shown = console->gpu.drawing();
+
+    // real frame keeps its audio
+    console->gpu.draw(false);
+    runFrame(in);
+    saveState(state);
+
+    // speculative frames leave no audio or debug output
+    in.reset = false;
+    console->mixer.discard(true);
+    console->quiet = true;
+    for (dt i = 0; i < frames; i++) {
+        console->gpu.ahead(shown && i + 1 == frames);
+        runFrame(in);
+    };
+    console->mixer.discard(false);
+    console->quiet = false;
+    loadState(state);
+};
@@ -0,0 +1,216 @@
+// -- frame telemetry -- //
+
+// measured phases of a frame
+enum Phase {
+    PHASE_EVENTS,
+    PHASE_NMI,
+    PHASE_DMA,
+    PHASE_CPU,
+    PHASE_LAYERS,
+    PHASE_SPRITES,
+    PHASE_COMPOSE,
+    PHASE_SCALE,
+    PHASE_PRESENT,
+    PHASE_AUDIO,
+    PHASES
+};
+const st phaseNames[PHASES] = {"events", "nmi", "dma", "cpu", "layers", "sprites", "compose", "scale", "present", "audio"};
+const st phaseLabels[PHASES] = {"EVT", "NMI", "DMA", "CPU", "LAY", "SPR", "CMP", "SCL", "PRS", "APU"};
+
+// telemetry sizes
+const dt sampleQueue = 256;
+const dt sampleWindow = 128;
+const int hudRows = PHASES + 2;
+
+// measurements of one frame in nanoseconds
+struct Sample {
+    dt frame;
+    Uint64 instructions;
+    Uint64 cycles;
+    Uint64 time[PHASES];
+};
+
+// audio callback time since last collected frame
+std::atomic<Uint64> audioTime {0};
+
+// 3x5 glyphs for digits, letters, '.', '-' and '%'
+const st hudChars = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.-%";
+const Uint16 hudFont[39] {
+    0x7B6F, 0x2C97, 0x73E7, 0x73CF, 0x5BC9, 0x79CF, 0x79EF, 0x7249, 0x7BEF, 0x7BCF,
+    0x2BED, 0x6BAE, 0x3923, 0x6B6E, 0x79A7, 0x79A4, 0x396B, 0x5BED, 0x7497, 0x126A,
+    0x5BAD, 0x4927, 0x5FED, 0x6B6D, 0x2B6A, 0x6BA4, 0x2B73, 0x6BAD, 0x388E, 0x7492,
+    0x5B6F, 0x5B6A, 0x5BFD, 0x5AAD, 0x5A92, 0x72A7, 0x0002, 0x01C0, 0x52A5
+};
+
+// per-frame csv log and rolling percentile overlay
+class Telemetry {
+    public:
+    // write one row per frame to path
+    bool open(st path) {
+        m_file = fopen(path, "w");
+        if (m_file == null)
+            return false;
+        fprintf(m_file, "frame,instructions,cycles");
+        for (int p = 0; p < PHASES; p++)
+            fprintf(m_file, ",%s_us", phaseNames[p]);
+        fprintf(m_file, "\n");
+        m_logging = true;
+        return true;
+    };
+
+    // measuring for log or overlay, safe from any thread
+    bool active() {
+        return m_logging || m_hud;
+    };
+    // show or hide overlay
+    void toggle() {
+        m_hud = !m_hud;
+    };
+    bool shown() {
+        return m_hud;
+    };
+
+    // hand emulated frame to presentation, dropped when behind
+    void push(const Sample& sample) {
+        if (!m_queue.push(sample))
+            m_dropped++;
+    };
+    // add presentation thread time
+    void host(Phase phase, Uint64 time) {
+        m_host.time[phase] += time;
+    };
+
+    // log frames finished since last call
+    void collect() {
+        Uint64 audio = audioTime.exchange(0);
+        Sample sample;
+        bool any = false;
+        while (m_queue.peek(sample)) {
+            m_queue.pop();
+
+            // host time goes to the first frame it overlaps
+            if (!any) {
+                for (int p : {PHASE_EVENTS, PHASE_SCALE, PHASE_PRESENT})
+                    sample.time[p] = m_host.time[p];
+                sample.time[PHASE_AUDIO] = audio;
+                m_host = Sample();
+                any = true;
+            };
+            record(sample);
+        };
+        if (any && m_hud)
+            percentiles();
+    };
+
+    // draw overlay into frame
+    void draw(SDL_Surface* frame) {
+        if (m_count == 0)
+            return;
+
+        // dim backdrop
+        int width = 21 * 4 + 3;
+        int height = (hudRows + 1) * 6 + 3;
+        for (int y = 0; y < height; y++) {
+            Uint32* row = (Uint32*)((Uint8*)frame->pixels + frame->pitch * y);
+            for (int x = 0; x < width; x++)
+                row[x] = (row[x] >> 2) & 0xFF3F3F3F;
+        };
+
+        // milliseconds and thousands of instructions at p50, p95 and p99
+        char line[32];
+        text(frame, 2, 2, "    P50   P95   P99");
+        for (int r = 0; r < hudRows; r++) {
+            st label = r < PHASES ? phaseLabels[r] : r == PHASES ? "ALL" : "INS";
+            if (r == PHASES + 1)
+                snprintf(line, sizeof(line), "%s %4.0fK %4.0fK %4.0fK", label, m_stats[r][0] / 1000.0, m_stats[r][1] / 1000.0, m_stats[r][2] / 1000.0);
+            else
+                snprintf(line, sizeof(line), "%s %5.2f %5.2f %5.2f", label, m_stats[r][0] / 1000000.0, m_stats[r][1] / 1000000.0, m_stats[r][2] / 1000000.0);
+            text(frame, 2, 8 + r * 6, line);
+        };
+    };
+
+    // close log
+    void close() {
+        m_logging = false;
+        if (m_file)
+            fclose(m_file);
+        m_file = null;
+        if (m_dropped)
+            printf(" - Telemetry dropped %u frames\n", dt(m_dropped));
+    };
+
+    private:
+    // append row to log and window
+    void record(const Sample& sample) {
+        if (m_file) {
+            fprintf(m_file, "%u,%llu,%llu", sample.frame, (unsigned long long)sample.instructions, (unsigned long long)sample.cycles);
+            for (int p = 0; p < PHASES; p++)
+                fprintf(m_file, ",%.1f", sample.time[p] / 1000.0);
+            fprintf(m_file, "\n");
+        };
+
+        // phases, frame total and instructions
+        Uint64* slot = m_window[m_next];
+        Uint64 total = 0;
+        for (int p = 0; p < PHASES; p++) {
+            slot[p] = sample.time[p];
+            total += sample.time[p];
+        };
+        slot[PHASES] = total;
+        slot[PHASES + 1] = sample.instructions;
+        m_next = (m_next + 1) % sampleWindow;
+        if (m_count < sampleWindow)
+            m_count++;
+    };
+
+    // sort window columns
+    void percentiles() {
+        Uint64 column[sampleWindow];
+        for (int r = 0; r < hudRows; r++) {
+            for (dt i = 0; i < m_count; i++) {
+                Uint64 value = m_window[i][r];
+                dt j = i;
+                for (; j > 0 && column[j - 1] > value; j--)
+                    column[j] = column[j - 1];
+                column[j] = value;
+            };
+            m_stats[r][0] = column[m_count * 50 / 100];
+            m_stats[r][1] = column[m_count * 95 / 100];
+            m_stats[r][2] = column[m_count * 99 / 100];
+        };
+    };
+
+    // white glyphs, unknown characters are blank
+    void text(SDL_Surface* frame, int x, int y, st str) {
+        for (; *str; str++, x += 4) {
+            st found = strchr(hudChars, *str);
+            if (*str == ' ' || found == null)
+                continue;
+            Uint16 glyph = hudFont[found - hudChars];
+            for (int gy = 0; gy < 5; gy++) {
+                Uint32* row = (Uint32*)((Uint8*)frame->pixels + frame->pitch * (y + gy)) + x;
+                for (int gx = 0; gx < 3; gx++) {
+                    if (glyph >> (14 - gy * 3 - gx) & 1)
+                        row[gx] = 0xFFFFFFFF;
+                };
+            };
+        };
+    };
+
+    // log and overlay state
+    FILE* m_file = null;
+    std::atomic<bool> m_logging {false};
+    std::atomic<bool> m_hud {false};
+    std::atomic<dt> m_dropped {0};
+
+    // frames in flight and presentation time
+    Queue<Sample, sampleQueue> m_queue;
+    Sample m_host = Sample();
+
+    // rolling window
+    Uint64 m_window[sampleWindow][hudRows];
+    Uint64 m_stats[hudRows][3] = {};
+    dt m_next = 0;
+    dt m_count = 0;
+};
+Telemetry telemetry;
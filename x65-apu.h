@@ -1,169 +1,783 @@
-// -- audio -- //
-
-// constants
-const int sampleRate = 44100;
-const int sampleCount = 735;
-const int sampleCost = 64;
-const int waveSize = 512;
-
-// waveform buffer
-Uint8 waveBuffer[32768];
-
-// channel object
-class Channel {
-    public:
-    // constructor
-    Channel () {
-        m_active = false;
-        m_phase = 0.0;
-        m_freq = 0.0;
-        m_lvol = 0.0;
-        m_rvol = 0.0;
-        m_jump = 0.0;
-        m_rep = false;
-    };
-    // set frequency
-    void freq(int value) {
-        m_freq = value;
-        m_phase = 0.0;
-    };
-    void freqL(Uint8 value) {
-        m_freq = (m_freq & 0xFF00) | value;
-    };
-    void freqH(Uint8 value) {
-        m_freq = (m_freq & 0x00FF) | ((value & 0x3F) << 8);
-    };
-    // set volume
-    void volL(Uint8 value) {
-        m_lvol = float(value) / 255.0;
-    };
-    void volR(Uint8 value) {
-        m_rvol = float(value) / 255.0;
-    };
-    // set loop
-    void loopL(Uint8 value) {
-        m_loop = (m_loop & 0xFF00) | value;
-        m_jump = float(m_loop) / 512;
-    };
-    void loopH(Uint8 value) {
-        if (value >= 2) {
-            m_rep = false;
-        } else {
-            m_loop = (m_loop & 0x00FF) | (value << 8);
-            m_jump = float(m_loop) / 512;
-            m_rep = true;
-        };
-    };
-    // set wave form
-    void wave(Uint8 id) {
-        m_wave = id & 0x7F;
-        m_phase = 0.0;
-    };
-    // toggle state
-    void enable(bool state) {
-        m_active = state;
-        m_phase = 0.0;
-    };
-    // get next sample
-    Uint32 next(unsigned int rate) {
-        // check for state
-        if (!m_active)
-            return 0;
-
-        // update phase
-        m_phase += float(m_freq) / rate;
-        if (m_phase >= 1.0) {
-            if (m_rep) {
-                m_phase += m_jump;
-                m_phase = fmod(m_phase, 1.0);
-            } else return 0;
-        };
-
-        // return samples
-        Uint16 full = waveBuffer[int(m_phase * waveSize) + waveSize * m_wave] * sampleCost;
-        return Uint16(full * m_lvol) << 16 | Uint16(full * m_rvol);
-    };
-
-    private:
-    bool m_active;
-    float m_phase;
-    float m_lvol;
-    float m_rvol;
-    float m_jump;
-    short m_freq;
-    bool m_rep;
-    bt m_wave;
-    wt m_loop;
-};
-
-// mixer object
-class Mixer {
-    public:
-    // set sample rate
-    void rate(unsigned int value) {
-        m_rate = value;
-    };
-    // access mixer channel
-    Channel& channel(int id) {
-        return m_channels[id];
-    };
-    // get next sample
-    Uint32 next() {
-        // merge all samples
-        Uint16 lvalue = 0;
-        Uint16 rvalue = 0;
-
-        for (int i = 0; i < 8; i++) {
-            Uint32 sample = m_channels[i].next(m_rate);
-            lvalue += sample & 0xFFFF;
-            rvalue += sample >> 16;
-        };
-        return lvalue << 16 | rvalue;
-    };
-
-    private:
-    Channel m_channels[8];
-    unsigned int m_rate;
-};
-
-// apu object
-namespace APU {
-    Mixer mixer;
-
-    // audio callback
-    void callback(void* ign, Uint8* dst, int len) {
-        Uint16* stream = (Uint16*)dst;
-
-        // fill buffer
-        for (unsigned int i = 0; i < len / sizeof(Uint16) / 2; i++) {
-            Uint32 sample = mixer.next();
-            stream[i * 2 + 0] = sample & 0xFFFF;
-            stream[i * 2 + 1] = sample >> 16;
-        };
-    };
-
-    // constructor
-    bool create(unsigned int rate) {
-        // create audio device
-        SDL_AudioSpec dev;
-        dev.callback = callback;
-        dev.format = AUDIO_U16;
-        dev.freq = sampleRate;
-        dev.samples = sampleCount;
-        dev.channels = 2;
-
-        // open audio device
-        if (SDL_OpenAudio(&dev, null)) {
-            return false;
-        };
-
-        // setup mixer
-        mixer.rate(rate);
-
-        // start audio playback
-        SDL_PauseAudio(0);
-
-        // success
-        return true;
-    };
-};
+// -- audio -- //
+
+// constants
+const int sampleRate = 44100;
+const int sampleCount = 735;
+const int sampleCost = 64;
+const int waveSize = 512;
+
+// waveform buffer, padded for 32-bit gathers
+Uint8 waveBuffer[waveSize * 0x80 + 4];
+
+// fixed point phase
+const int phaseBits = 32;
+const Uint64 phaseOne = 1ull << phaseBits;
+
+// interpolation modes
+enum Filter {
+    SINC = 0,
+    LINEAR, NEAREST,
+    FILTERS
+};
+
+// band-limited wave levels, each an octave below the last
+const int levelCount = 9;
+const int levelGuard = 8;
+const int levelStride = 1152;
+const int kernelTaps = 8;
+const int kernelPhases = 64;
+const int kernelBits = 14;
+const int halfTaps = 15;
+
+// level data with wrapped guard samples around each octave
+Sint16 waveLevels[0x80][levelStride];
+int levelOffset[levelCount];
+Sint16 sincKernel[kernelPhases][kernelTaps];
+
+// windowed sinc at cutoff in cycles per sample
+double windowedSinc(double x, double cutoff, double span) {
+    double w = 0.42 + 0.5 * cos(M_PI * x / span) + 0.08 * cos(2 * M_PI * x / span);
+    if (x == 0)
+        return 2 * cutoff * w;
+    return sin(2 * M_PI * cutoff * x) / (M_PI * x) * w;
+};
+
+// precompute polyphase interpolation kernels
+void buildKernels() {
+    for (int p = 0; p < kernelPhases; p++) {
+        double taps[kernelTaps];
+        double sum = 0;
+        for (int t = 0; t < kernelTaps; t++) {
+            taps[t] = windowedSinc(t - 3 - double(p) / kernelPhases, 0.45, kernelTaps / 2);
+            sum += taps[t];
+        };
+
+        // normalize for unity gain, rounding error goes to the center tap
+        int total = 0;
+        for (int t = 0; t < kernelTaps; t++) {
+            sincKernel[p][t] = lround(taps[t] / sum * (1 << kernelBits));
+            total += sincKernel[p][t];
+        };
+        sincKernel[p][3] += (1 << kernelBits) - total;
+    };
+
+    // level layout
+    int offset = 0;
+    for (int k = 0; k < levelCount; k++) {
+        levelOffset[k] = offset;
+        offset += (waveSize >> k) + levelGuard;
+    };
+};
+
+// decimate loaded waves into octave levels
+void buildWaves() {
+    double half[halfTaps];
+    double sum = 0;
+    for (int m = 0; m < halfTaps; m++) {
+        half[m] = windowedSinc(m - halfTaps / 2, 0.25, halfTaps / 2 + 1);
+        sum += half[m];
+    };
+    for (int m = 0; m < halfTaps; m++)
+        half[m] /= sum;
+
+    for (int id = 0; id < 0x80; id++) {
+        Sint16* level = waveLevels[id];
+        int size = waveSize;
+        for (int i = 0; i < size; i++)
+            level[i + 3] = waveBuffer[id * waveSize + i] * sampleCost;
+
+        for (int k = 0; k < levelCount; k++) {
+            Sint16* cur = waveLevels[id] + levelOffset[k];
+            size = waveSize >> k;
+
+            // next octave from low passed samples
+            if (k > 0) {
+                Sint16* prev = waveLevels[id] + levelOffset[k - 1];
+                for (int i = 0; i < size; i++) {
+                    double acc = 0;
+                    for (int m = 0; m < halfTaps; m++)
+                        acc += half[m] * prev[((i * 2 + m - halfTaps / 2) & (size * 2 - 1)) + 3];
+                    cur[i + 3] = lround(acc < 0 ? 0 : acc > 0xFF * sampleCost ? 0xFF * sampleCost : acc);
+                };
+            };
+
+            // wrap guard samples
+            for (int i = 0; i < 3; i++)
+                cur[i] = cur[3 + ((size - 3 + i) & (size - 1))];
+            for (int i = 0; i < levelGuard - 3; i++)
+                cur[size + 3 + i] = cur[3 + (i & (size - 1))];
+        };
+    };
+};
+
+// channel state in structure of arrays layout
+struct Voices {
+    alignas(32) Uint32 phase[8];
+    alignas(32) Uint32 step[8];
+    alignas(32) Uint32 jump[8];
+    alignas(32) Uint32 lvol[8];
+    alignas(32) Uint32 rvol[8];
+    alignas(32) Uint32 base[8];
+    alignas(32) Uint32 active[8];
+    alignas(32) Uint32 rep[8];
+    alignas(32) Uint32 done[8];
+    Uint8 level[8];
+    wt freq[8];
+    wt loop[8];
+    unsigned int rate;
+};
+
+// channel object
+class Channel {
+    public:
+    // constructor
+    Channel (Voices& voices, int id) : m_v(voices), m_id(id) {};
+    // set frequency
+    void freq(int value) {
+        m_v.freq[m_id] = value;
+        restart();
+        update();
+    };
+    void freqL(Uint8 value) {
+        m_v.freq[m_id] = (m_v.freq[m_id] & 0xFF00) | value;
+        update();
+    };
+    void freqH(Uint8 value) {
+        m_v.freq[m_id] = (m_v.freq[m_id] & 0x00FF) | ((value & 0x3F) << 8);
+        update();
+    };
+    // set volume
+    void volL(Uint8 value) {
+        m_v.lvol[m_id] = value;
+    };
+    void volR(Uint8 value) {
+        m_v.rvol[m_id] = value;
+    };
+    // set loop
+    void loopL(Uint8 value) {
+        m_v.loop[m_id] = (m_v.loop[m_id] & 0xFF00) | value;
+        m_v.jump[m_id] = Uint32(m_v.loop[m_id]) << (phaseBits - 9);
+    };
+    void loopH(Uint8 value) {
+        if (value >= 2) {
+            m_v.rep[m_id] = 0;
+        } else {
+            m_v.loop[m_id] = (m_v.loop[m_id] & 0x00FF) | (value << 8);
+            m_v.jump[m_id] = Uint32(m_v.loop[m_id]) << (phaseBits - 9);
+            m_v.rep[m_id] = ~0u;
+        };
+    };
+    // set wave form
+    void wave(Uint8 id) {
+        m_v.base[m_id] = (id & 0x7F) * waveSize;
+        restart();
+    };
+    // toggle state
+    void enable(bool state) {
+        m_v.active[m_id] = state ? ~0u : 0;
+        restart();
+    };
+    // precompute phase step
+    void update() {
+        Uint64 step = (Uint64(m_v.freq[m_id]) << phaseBits) / m_v.rate;
+        m_v.step[m_id] = step < phaseOne ? step : phaseOne - 1;
+
+        // lowest octave advancing less than one sample per step
+        int k = 0;
+        while (k < levelCount - 1 && (step >> (phaseBits - 9 + k)))
+            k++;
+        m_v.level[m_id] = k;
+    };
+
+    private:
+    void restart() {
+        m_v.phase[m_id] = 0;
+        m_v.done[m_id] = 0;
+    };
+
+    Voices& m_v;
+    int m_id;
+};
+
+// scale sample by volume, exact floor(w * 64 * vol / 255)
+inline Uint32 volume(Uint32 w, Uint32 vol) {
+    return w * sampleCost * vol / 255;
+};
+
+// clamp mixed sample
+inline Uint16 saturate(Uint32 value) {
+    return value > 0xFFFF ? 0xFFFF : value;
+};
+
+// update channel phase, false while silent
+inline bool stepPhase(Voices& v, int i) {
+    // check for state
+    if (!v.active[i])
+        return false;
+
+    // update phase, a finished channel wraps once looping
+    Uint32 phase = v.phase[i] + v.step[i];
+    if (phase < v.phase[i] || v.done[i]) {
+        if (!v.rep[i]) {
+            v.phase[i] = 0;
+            v.done[i] = ~0u;
+            return false;
+        };
+        phase += v.jump[i];
+        v.done[i] = 0;
+    };
+    v.phase[i] = phase;
+    return true;
+};
+
+// scalar mixer
+void mixScalar(Voices& v, Uint16* buffer, int count) {
+    for (int s = 0; s < count; s++) {
+        Uint32 lvalue = 0;
+        Uint32 rvalue = 0;
+
+        // merge samples
+        for (int i = 0; i < 8; i++) {
+            if (!stepPhase(v, i))
+                continue;
+
+            Uint32 w = waveBuffer[v.base[i] + (v.phase[i] >> (phaseBits - 9))];
+            lvalue += volume(w, v.lvol[i]);
+            rvalue += volume(w, v.rvol[i]);
+        };
+        buffer[s * 2 + 0] = saturate(lvalue);
+        buffer[s * 2 + 1] = saturate(rvalue);
+    };
+};
+
+// linear interpolating mixer
+void mixLinear(Voices& v, Uint16* buffer, int count) {
+    for (int s = 0; s < count; s++) {
+        Uint32 lvalue = 0;
+        Uint32 rvalue = 0;
+
+        for (int i = 0; i < 8; i++) {
+            if (!stepPhase(v, i))
+                continue;
+
+            // blend neighbouring samples of the band-limited level
+            int k = v.level[i];
+            const Sint16* w = waveLevels[v.base[i] / waveSize] + levelOffset[k] + 3;
+            Uint32 pos = v.phase[i] >> (phaseBits - 9 + k);
+            Sint32 frac = (v.phase[i] >> (phaseBits - 25 + k)) & 0xFFFF;
+            Uint32 full = w[pos] + ((w[pos + 1] - w[pos]) * frac >> 16);
+
+            lvalue += full * v.lvol[i] / 255;
+            rvalue += full * v.rvol[i] / 255;
+        };
+        buffer[s * 2 + 0] = saturate(lvalue);
+        buffer[s * 2 + 1] = saturate(rvalue);
+    };
+};
+
+// windowed sinc mixer
+void mixSinc(Voices& v, Uint16* buffer, int count) {
+    for (int s = 0; s < count; s++) {
+        Uint32 lvalue = 0;
+        Uint32 rvalue = 0;
+
+        for (int i = 0; i < 8; i++) {
+            if (!stepPhase(v, i))
+                continue;
+
+            // polyphase kernel over contiguous guarded taps
+            int k = v.level[i];
+            const Sint16* w = waveLevels[v.base[i] / waveSize] + levelOffset[k];
+            Uint32 pos = v.phase[i] >> (phaseBits - 9 + k);
+            const Sint16* c = sincKernel[(v.phase[i] >> (phaseBits - 15 + k)) & (kernelPhases - 1)];
+            Sint32 acc = 1 << (kernelBits - 1);
+            for (int t = 0; t < kernelTaps; t++)
+                acc += c[t] * w[pos + t];
+
+            // clamp ringing to the sample range
+            acc >>= kernelBits;
+            Uint32 full = acc < 0 ? 0 : acc > 0xFF * sampleCost ? 0xFF * sampleCost : acc;
+            lvalue += full * v.lvol[i] / 255;
+            rvalue += full * v.rvol[i] / 255;
+        };
+        buffer[s * 2 + 0] = saturate(lvalue);
+        buffer[s * 2 + 1] = saturate(rvalue);
+    };
+};
+
+#ifdef X65_SIMD
+// avx2 mixer
+TARGET("avx2") inline __m256i div255AVX2(__m256i n) {
+    // exact floor(n / 255) for n <= 0xFF * 0xFF
+    const __m256i one = _mm256_set1_epi16(1);
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(n, one), _mm256_srli_epi16(n, 8)), 8);
+};
+TARGET("avx2") inline __m256i volumeAVX2(__m256i w, __m256i vol) {
+    // split w * 64 * vol / 255 into two exact 16-bit divisions
+    __m256i n = _mm256_mullo_epi16(w, vol);
+    __m256i q = div255AVX2(n);
+    __m256i r = _mm256_sub_epi16(n, _mm256_sub_epi16(_mm256_slli_epi16(q, 8), q));
+    return _mm256_add_epi16(_mm256_slli_epi16(q, 6), div255AVX2(_mm256_slli_epi16(r, 6)));
+};
+TARGET("avx2") inline __m256i div255WideAVX2(__m256i n) {
+    // exact floor(n / 255) for n <= 0xFF * 0xFF * sampleCost
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i m = _mm256_add_epi32(n, one);
+    return _mm256_srli_epi32(_mm256_add_epi32(m, _mm256_srli_epi32(_mm256_add_epi32(m, _mm256_srli_epi32(n, 8)), 8)), 8);
+};
+TARGET("avx2") inline __m256i stepAVX2(__m256i& phase, __m256i& done, __m256i step, __m256i jump, __m256i rep, __m256i active) {
+    // update phase, unsigned compare finds carry, returns sounding channels
+    const __m256i sign = _mm256_set1_epi32(0x80000000);
+    __m256i next = _mm256_add_epi32(phase, step);
+    __m256i carry = _mm256_cmpgt_epi32(_mm256_xor_si256(phase, sign), _mm256_xor_si256(next, sign));
+    carry = _mm256_and_si256(_mm256_or_si256(carry, done), active);
+    done = _mm256_andnot_si256(rep, carry);
+    __m256i live = _mm256_andnot_si256(done, active);
+    next = _mm256_add_epi32(next, _mm256_and_si256(jump, carry));
+    phase = _mm256_andnot_si256(done, _mm256_blendv_epi8(phase, next, active));
+    return live;
+};
+TARGET("avx2") inline void panAVX2(__m256i full, __m256i lvol, __m256i rvol, Uint16* out) {
+    // scale both sides and sum the eight channels of each
+    __m256i l = div255WideAVX2(_mm256_mullo_epi32(full, lvol));
+    __m256i r = div255WideAVX2(_mm256_mullo_epi32(full, rvol));
+    __m256i sum = _mm256_hadd_epi32(l, r);
+    sum = _mm256_hadd_epi32(sum, sum);
+    __m128i both = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    both = _mm_min_epu32(both, _mm_set1_epi32(0xFFFF));
+    out[0] = _mm_cvtsi128_si32(both);
+    out[1] = _mm_extract_epi32(both, 1);
+};
+TARGET("avx2") void mixAVX2(Voices& v, Uint16* buffer, int count) {
+    const __m256i byte = _mm256_set1_epi32(0xFF);
+    const __m128i limit = _mm_set1_epi32(0xFFFF);
+
+    // load channel state
+    __m256i phase = _mm256_load_si256((const __m256i*)v.phase);
+    __m256i step = _mm256_load_si256((const __m256i*)v.step);
+    __m256i jump = _mm256_load_si256((const __m256i*)v.jump);
+    __m256i base = _mm256_load_si256((const __m256i*)v.base);
+    __m256i rep = _mm256_load_si256((const __m256i*)v.rep);
+    __m256i done = _mm256_load_si256((const __m256i*)v.done);
+    __m256i active = _mm256_load_si256((const __m256i*)v.active);
+
+    // left volume in low half, right volume in high half
+    __m256i vol = _mm256_or_si256(
+        _mm256_load_si256((const __m256i*)v.lvol),
+        _mm256_slli_epi32(_mm256_load_si256((const __m256i*)v.rvol), 16)
+    );
+
+    for (int s = 0; s < count; s++) {
+        __m256i live = stepAVX2(phase, done, step, jump, rep, active);
+
+        // gather samples for both sides
+        __m256i index = _mm256_add_epi32(base, _mm256_srli_epi32(phase, phaseBits - 9));
+        __m256i w = _mm256_and_si256(_mm256_i32gather_epi32((const int*)waveBuffer, index, 1), byte);
+        w = _mm256_and_si256(w, live);
+        __m256i mix = volumeAVX2(_mm256_or_si256(w, _mm256_slli_epi32(w, 16)), vol);
+
+        // four channels per half still fit in 16 bits
+        mix = _mm256_add_epi16(mix, _mm256_shuffle_epi32(mix, 0x4E));
+        mix = _mm256_add_epi16(mix, _mm256_shuffle_epi32(mix, 0xB1));
+        __m128i both = _mm_add_epi32(
+            _mm_cvtepu16_epi32(_mm256_castsi256_si128(mix)),
+            _mm_cvtepu16_epi32(_mm256_extracti128_si256(mix, 1))
+        );
+        both = _mm_min_epu32(both, limit);
+        buffer[s * 2 + 0] = _mm_cvtsi128_si32(both);
+        buffer[s * 2 + 1] = _mm_extract_epi32(both, 1);
+    };
+
+    // store channel state
+    _mm256_store_si256((__m256i*)v.phase, phase);
+    _mm256_store_si256((__m256i*)v.done, done);
+};
+
+// per channel start of its band-limited level and octave shift
+struct LevelLanes {
+    alignas(32) Sint32 origin[8];
+    alignas(32) Uint32 octave[8];
+};
+inline void levelLanes(const Voices& v, LevelLanes& lanes) {
+    for (int i = 0; i < 8; i++) {
+        lanes.origin[i] = v.base[i] / waveSize * levelStride + levelOffset[v.level[i]];
+        lanes.octave[i] = v.level[i];
+    };
+};
+
+// avx2 linear interpolating mixer, matches mixLinear
+TARGET("avx2") void mixLinearAVX2(Voices& v, Uint16* buffer, int count) {
+    const __m256i low = _mm256_set1_epi32(0xFFFF);
+    LevelLanes lanes;
+    levelLanes(v, lanes);
+
+    // load channel state
+    __m256i phase = _mm256_load_si256((const __m256i*)v.phase);
+    __m256i step = _mm256_load_si256((const __m256i*)v.step);
+    __m256i jump = _mm256_load_si256((const __m256i*)v.jump);
+    __m256i rep = _mm256_load_si256((const __m256i*)v.rep);
+    __m256i done = _mm256_load_si256((const __m256i*)v.done);
+    __m256i active = _mm256_load_si256((const __m256i*)v.active);
+    __m256i lvol = _mm256_load_si256((const __m256i*)v.lvol);
+    __m256i rvol = _mm256_load_si256((const __m256i*)v.rvol);
+    __m256i octave = _mm256_load_si256((const __m256i*)lanes.octave);
+    __m256i origin = _mm256_add_epi32(_mm256_load_si256((const __m256i*)lanes.origin), _mm256_set1_epi32(3));
+    __m256i posShift = _mm256_add_epi32(octave, _mm256_set1_epi32(phaseBits - 9));
+    __m256i fracShift = _mm256_add_epi32(octave, _mm256_set1_epi32(phaseBits - 25));
+
+    for (int s = 0; s < count; s++) {
+        __m256i live = stepAVX2(phase, done, step, jump, rep, active);
+
+        // neighbouring samples in one gather, low half first
+        __m256i index = _mm256_add_epi32(origin, _mm256_srlv_epi32(phase, posShift));
+        __m256i pair = _mm256_i32gather_epi32((const int*)waveLevels, index, 2);
+        __m256i w0 = _mm256_srai_epi32(_mm256_slli_epi32(pair, 16), 16);
+        __m256i w1 = _mm256_srai_epi32(pair, 16);
+        __m256i frac = _mm256_and_si256(_mm256_srlv_epi32(phase, fracShift), low);
+        __m256i full = _mm256_add_epi32(w0, _mm256_srai_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(w1, w0), frac), 16));
+        panAVX2(_mm256_and_si256(full, live), lvol, rvol, buffer + s * 2);
+    };
+
+    // store channel state
+    _mm256_store_si256((__m256i*)v.phase, phase);
+    _mm256_store_si256((__m256i*)v.done, done);
+};
+
+// avx2 windowed sinc mixer, matches mixSinc
+TARGET("avx2") void mixSincAVX2(Voices& v, Uint16* buffer, int count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ceiling = _mm256_set1_epi32(0xFF * sampleCost);
+    const __m256i round = _mm256_set1_epi32(1 << (kernelBits - 1));
+    const __m256i phases = _mm256_set1_epi32(kernelPhases - 1);
+    LevelLanes lanes;
+    levelLanes(v, lanes);
+
+    // load channel state
+    __m256i phase = _mm256_load_si256((const __m256i*)v.phase);
+    __m256i step = _mm256_load_si256((const __m256i*)v.step);
+    __m256i jump = _mm256_load_si256((const __m256i*)v.jump);
+    __m256i rep = _mm256_load_si256((const __m256i*)v.rep);
+    __m256i done = _mm256_load_si256((const __m256i*)v.done);
+    __m256i active = _mm256_load_si256((const __m256i*)v.active);
+    __m256i lvol = _mm256_load_si256((const __m256i*)v.lvol);
+    __m256i rvol = _mm256_load_si256((const __m256i*)v.rvol);
+    __m256i octave = _mm256_load_si256((const __m256i*)lanes.octave);
+    __m256i origin = _mm256_load_si256((const __m256i*)lanes.origin);
+    __m256i posShift = _mm256_add_epi32(octave, _mm256_set1_epi32(phaseBits - 9));
+    __m256i kernelShift = _mm256_add_epi32(octave, _mm256_set1_epi32(phaseBits - 15));
+
+    for (int s = 0; s < count; s++) {
+        __m256i live = stepAVX2(phase, done, step, jump, rep, active);
+
+        // tap pairs of samples and kernel multiplied and summed by madd
+        __m256i index = _mm256_add_epi32(origin, _mm256_srlv_epi32(phase, posShift));
+        __m256i kernel = _mm256_slli_epi32(_mm256_and_si256(_mm256_srlv_epi32(phase, kernelShift), phases), 3);
+        __m256i acc = round;
+        for (int t = 0; t < kernelTaps; t += 2) {
+            __m256i w = _mm256_i32gather_epi32((const int*)waveLevels, _mm256_add_epi32(index, _mm256_set1_epi32(t)), 2);
+            __m256i c = _mm256_i32gather_epi32((const int*)sincKernel, _mm256_add_epi32(kernel, _mm256_set1_epi32(t)), 2);
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(c, w));
+        };
+
+        // clamp ringing to the sample range
+        __m256i full = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(acc, kernelBits), zero), ceiling);
+        panAVX2(_mm256_and_si256(full, live), lvol, rvol, buffer + s * 2);
+    };
+
+    // store channel state
+    _mm256_store_si256((__m256i*)v.phase, phase);
+    _mm256_store_si256((__m256i*)v.done, done);
+};
+#endif
+
+// register write event
+struct Event {
+    Uint64 time;
+    wt reg;
+    bt data;
+};
+
+// event queue constants
+const dt eventCount = 4096;
+
+// output ring constants
+const dt ringSize = 8192;
+const dt ringTarget = sampleCount * 2;
+const double maxSkew = 0.005;
+const double levelSmooth = 0.05;
+
+// mixer object
+class Mixer {
+    public:
+    // constructor
+    Mixer () {
+        m_voices = Voices();
+        m_voices.rate = sampleRate;
+        m_nearest = mixScalar;
+        m_linear = mixLinear;
+        m_sinc = mixSinc;
+        m_mix = mixSinc;
+        m_filter = SINC;
+        m_clock = 0;
+        m_mute = false;
+        m_discard = false;
+        m_primed = false;
+        m_level = ringTarget;
+        m_frac = 0;
+        m_prev = 0;
+        m_next = 0;
+    };
+    // set sample rate
+    void rate(unsigned int value) {
+        m_voices.rate = value;
+        for (int i = 0; i < 8; i++)
+            channel(i).update();
+
+        // select mixer for host cpu
+        #ifdef X65_SIMD
+        if (SDL_HasAVX2()) {
+            m_nearest = mixAVX2;
+            m_linear = mixLinearAVX2;
+            m_sinc = mixSincAVX2;
+        };
+        #endif
+        filter(m_filter);
+    };
+    // select interpolation mode
+    void filter(dt mode) {
+        m_filter = mode % FILTERS;
+        if (m_filter == SINC)
+            m_mix = m_sinc;
+        else if (m_filter == LINEAR)
+            m_mix = m_linear;
+        else
+            m_mix = m_nearest;
+    };
+    // access mixer channel
+    Channel channel(int id) {
+        return Channel(m_voices, id);
+    };
+    // queue register write at emulated scanline
+    void write(Uint64 line, wt reg, bt data) {
+        if (m_discard)
+            return;
+
+        Event evt;
+        evt.time = line * m_voices.rate / (frameRate * lineCount);
+        evt.reg = reg;
+        evt.data = data;
+
+        // mix pending writes early when the queue is full
+        if (!m_queue.push(evt)) {
+            advance(line);
+            m_queue.push(evt);
+        };
+    };
+    // skip mixing while in turbo mode
+    void mute(bool state) {
+        m_mute = state;
+    };
+    // drop writes from speculative frames
+    void discard(bool state) {
+        m_discard = state;
+    };
+    // mix samples up to emulated scanline into the output ring
+    void advance(Uint64 line) {
+        Uint64 end = line * m_voices.rate / (frameRate * lineCount);
+        Event evt;
+
+        // apply writes without mixing while muted
+        if (m_mute) {
+            while (m_queue.peek(evt) && evt.time < end) {
+                apply(evt.reg, evt.data);
+                m_queue.pop();
+            };
+            m_clock = end;
+            return;
+        };
+
+        while (m_clock < end) {
+            int count = end - m_clock < sampleCount ? end - m_clock : sampleCount;
+            render(m_block, count);
+
+            // drop samples when the audio device falls behind
+            for (int i = 0; i < count; i++) {
+                if (!m_ring.push(m_block[i * 2] | Uint32(m_block[i * 2 + 1]) << 16))
+                    break;
+            };
+        };
+    };
+    // take mixed samples without resampling
+    int drain(Uint16* buffer, int count) {
+        Uint32 sample;
+        int i = 0;
+        for (; i < count && m_ring.peek(sample); i++) {
+            m_ring.pop();
+            buffer[i * 2 + 0] = sample & 0xFFFF;
+            buffer[i * 2 + 1] = sample >> 16;
+        };
+        return i;
+    };
+    // resample output ring into audio device buffer
+    void output(Uint16* buffer, int count) {
+        // wait for the ring to refill after running dry
+        dt fill = m_ring.fill();
+        if (fill >= ringTarget)
+            m_primed = true;
+
+        // nudge playback rate toward the target fill level
+        m_level += (double(fill) - m_level) * levelSmooth;
+        double skew = (m_level - ringTarget) / ringTarget * maxSkew;
+        if (skew > maxSkew) skew = maxSkew;
+        if (skew < -maxSkew) skew = -maxSkew;
+        Uint32 step = (1.0 + skew) * 65536;
+
+        for (int i = 0; i < count; i++) {
+            // step through ring samples
+            if (m_primed) {
+                m_frac += step;
+                while (m_frac >= 65536) {
+                    m_frac -= 65536;
+                    m_prev = m_next;
+                    if (!m_ring.peek(m_next)) {
+                        m_primed = false;
+                        m_frac = 0;
+                        break;
+                    };
+                    m_ring.pop();
+                };
+            };
+
+            // linear interpolation between samples
+            Sint32 l0 = m_prev & 0xFFFF, l1 = m_next & 0xFFFF;
+            Sint32 r0 = m_prev >> 16, r1 = m_next >> 16;
+            buffer[i * 2 + 0] = l0 + (Sint64(l1 - l0) * m_frac >> 16);
+            buffer[i * 2 + 1] = r0 + (Sint64(r1 - r0) * m_frac >> 16);
+        };
+    };
+
+    private:
+    // render block of stereo samples
+    void render(Uint16* buffer, int count) {
+        Event evt;
+
+        // mix up to each event, then apply it
+        int pos = 0;
+        while (pos < count) {
+            int end = count;
+            while (m_queue.peek(evt)) {
+                Sint64 at = evt.time - m_clock;
+                if (at > pos) {
+                    if (at < end)
+                        end = at;
+                    break;
+                };
+                apply(evt.reg, evt.data);
+                m_queue.pop();
+            };
+            m_mix(m_voices, buffer + pos * 2, end - pos);
+            pos = end;
+        };
+        m_clock += count;
+    };
+    // decode register write
+    void apply(wt reg, bt data) {
+        if (reg < 0x40) {
+            Channel ch = channel((reg & 0xE) >> 1);
+            switch (reg & 0x31) {
+                case 0x00:
+                ch.freqL(data);
+                break;
+                case 0x01:
+                ch.freqH(data);
+                break;
+                case 0x10:
+                ch.volL(data);
+                break;
+                case 0x11:
+                ch.volR(data);
+                break;
+                case 0x20:
+                ch.loopL(data);
+                break;
+                case 0x21:
+                ch.loopH(data);
+                break;
+                case 0x30:
+                case 0x31:
+                ch.wave(data);
+                break;
+            };
+        } else if (reg & 1) {
+            for (int i = 0; i < 8; i++) {
+                if (data & (1 << (i ^ 7)))
+                    channel(i).enable(true);
+            };
+        } else for (int i = 0; i < 8; i++) {
+            channel(i).enable(data & (1 << (i ^ 7)));
+        };
+    };
+
+    Voices m_voices;
+    void (*m_mix)(Voices&, Uint16*, int);
+    void (*m_nearest)(Voices&, Uint16*, int);
+    void (*m_linear)(Voices&, Uint16*, int);
+    void (*m_sinc)(Voices&, Uint16*, int);
+    dt m_filter;
+    Queue<Event, eventCount> m_queue;
+    Uint64 m_clock;
+    bool m_mute;
+    bool m_discard;
+    Uint16 m_block[sampleCount * 2];
+
+    // playback state
+    Queue<Uint32, ringSize> m_ring;
+    bool m_primed;
+    double m_level;
+    Uint32 m_frac;
+    Uint32 m_prev;
+    Uint32 m_next;
+};
+
+// apu object
+namespace APU {
+    // audio callback
+    void callback(void* data, Uint8* dst, int len) {
+        Uint64 mark = telemetry.active() ? Pacer::now() : 0;
+        ((Mixer*)data)->output((Uint16*)dst, len / sizeof(Uint16) / 2);
+        if (mark)
+            audioTime += Pacer::now() - mark;
+    };
+
+    // mixer without audio device
+    void setup(Mixer& mixer, unsigned int rate) {
+        buildKernels();
+        mixer.rate(rate);
+    };
+
+    // constructor
+    bool create(Mixer& mixer, unsigned int rate) {
+        // create audio device
+        SDL_AudioSpec dev;
+        dev.callback = callback;
+        dev.userdata = &mixer;
+        dev.format = AUDIO_U16;
+        dev.freq = sampleRate;
+        dev.samples = sampleCount;
+        dev.channels = 2;
+
+        // open audio device
+        if (SDL_OpenAudio(&dev, null)) {
+            return false;
+        };
+
+        // setup mixer
+        setup(mixer, rate);
+
+        // start audio playback
+        SDL_PauseAudio(0);
+
+        // success
+        return true;
+    };
+};
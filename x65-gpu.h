@@ -1,553 +1,1171 @@
-// -- engine -- //
-
-// key codes
-#define KEY_DOWN   0x001
-#define KEY_UP     0x002
-#define KEY_RIGHT  0x004
-#define KEY_LEFT   0x008
-#define KEY_Y      0x010
-#define KEY_X      0x020
-#define KEY_B      0x040
-#define KEY_A      0x080
-#define KEY_R      0x100
-#define KEY_L      0x200
-#define KEY_START  0x400
-#define KEY_SELECT 0x800
-
-// icon data
-const Uint16 g1 = 0xF334;
-const Uint16 g2 = 0xF223;
-const Uint16 g3 = 0xF112;
-const Uint16 p1 = 0xF9AB;
-const Uint16 b1 = 0x1000;
-const Uint16 b2 = 0x2000;
-
-Uint16 iconData[256] {
-    b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2,
-    b2, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
-    b2, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
-
-    b2, b1, b1, b1, g1, g1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
-    b2, b1, g1, g1, g1, g1, g1, g1, b1, b1, b1, b1, b1, b1, b1, b2,
-    b2, g1, g1, g1, g1, g1, g1, g1, g1, g1, b1, b1, b1, b1, b1, b2,
-    b2, g2, g1, g1, g1, g1, g1, g1, g1, g1, g1, g1, b1, b1, b1, b2,
-    b2, g2, g2, p1, g1, g1, g1, g1, g1, g1, g1, g1, g1, g1, b1, b2,
-    b2, b1, g2, p1, g2, p1, g1, g1, g1, g1, g1, g1, g1, g1, g1, b2,
-    b2, b1, p1, b1, g2, p1, g2, p1, g1, g1, g1, g1, g1, g1, g3, b2,
-    b2, b1, b1, b1, p1, b1, g2, p1, g2, p1, g1, g1, g3, g3, g3, b2,
-    b2, b1, b1, b1, b1, b1, p1, b1, g2, p1, g3, g3, g3, g3, b1, b2,
-    b2, b1, b1, b1, b1, b1, b1, b1, p1, b1, g3, g3, b1, b1, b1, b2,
-
-    b2, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
-    b2, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
-    b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2
-};
-
-// gpu object
-class GPU {
-    public:
-    // window creator
-    bool create(st name, int width, int height) {
-        // create window
-        m_win = SDL_CreateWindow(name, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, width, height, SDL_WINDOW_SHOWN);
-        if (m_win == null) return false;
-
-        // create surfaces
-        m_sur = SDL_CreateRGBSurfaceWithFormat(0, 16384, 8, 8, SDL_PIXELFORMAT_INDEX8);
-        m_buf = SDL_CreateRGBSurfaceWithFormat(0, 320, 240, 32, SDL_PIXELFORMAT_ARGB32);
-        m_scr = SDL_GetWindowSurface(m_win);
-        if (m_sur == null) return false;
-        if (m_buf == null) return false;
-
-        // set window icon
-        SDL_Surface* ico = SDL_CreateRGBSurfaceFrom(iconData, 16, 16, 16, 32, 0x0F00, 0x00F0, 0x000F, 0xF000);
-        SDL_SetWindowIcon(m_win, ico);
-        SDL_FreeSurface(ico);
-
-        // create palettes
-        for (int i = 0; i < 16; i++)
-            m_pal[i] = SDL_AllocPalette(16);
-
-        // power cycle
-        power();
-        nmib = false;
-        head = 0;
-
-        // success
-        m_keystate = SDL_GetKeyboardState(null);
-        m_keys1 = 0x000;
-        m_keys2 = 0x000;
-        m_run = true;
-        return true;
-    };
-
-    // destructor
-    ~GPU () {
-        SDL_DestroyWindow(m_win);
-        for (int i = 0; i < 16; i++)
-            SDL_FreePalette(m_pal[i]);
-        SDL_Quit();
-    };
-
-    // power cycle
-    void power() {
-        // randomize initial state
-        for (int i = 0; i < 16; i++) {
-            SDL_Color colors[16];
-            for (int j = 0; j < 16; j++) {
-                colors[j].r = 0x0;
-                colors[j].g = 0x0;
-                colors[j].b = 0x0;
-                colors[j].a = 0x0;
-            };
-            SDL_SetPaletteColors(m_pal[i], colors, 0, 16);
-        };
-        for (int l = 0; l < 2; l++) {
-            for (int r = 0; r < 4; r++) {
-                for (int i = 0; i < 1200; i++) {
-                    layers[l].data[r][i].p1 = 0x0;
-                    layers[l].data[r][i].p2 = 0x0;
-                };
-            };
-        };
-        for (int i = 0; i < 128; i++) {
-            sprites[i].p1 = 0x0;
-            sprites[i].p2 = 0x0;
-            sprites[i].p3 = 0x0;
-            sprites[i].p4 = 0x0;
-            sprites[i].p5 = 0x0;
-            sprites[i].p6 = 0x0;
-        };
-    };
-
-    // event handler
-    void events(CPU& cpu, SDL_Joystick*& joy1, SDL_Joystick*& joy2) {
-        SDL_Event evt;
-
-        // handler loop
-        while (SDL_PollEvent(&evt)) {
-            // quit event
-            if (evt.type == SDL_QUIT) {
-                m_run = false;
-                return;
-            };
-            // key press
-            if (evt.type == SDL_KEYDOWN) {
-                // reset console
-                if (evt.key.keysym.sym == SDLK_r) {
-                    vectorRST(cpu);
-                    continue;
-                };
-
-                // change window scale
-                if (evt.key.keysym.sym == SDLK_f) {
-                    m_scale = (m_scale + 1) & 3;
-                    SDL_SetWindowSize(m_win, 320 * (m_scale + 1), 240 * (m_scale + 1));
-                    m_scr = SDL_GetWindowSurface(m_win);
-                    continue;
-                };
-                continue;
-            };
-            // joystick events
-            if (evt.type == SDL_JOYDEVICEADDED) {
-                if (joy1) {
-                    if (!joy2)
-                        joy2 = SDL_JoystickOpen(evt.jdevice.which);
-                } else {
-                    joy1 = SDL_JoystickOpen(evt.jdevice.which);
-                };
-            };
-            if (evt.type == SDL_JOYDEVICEREMOVED) {
-                if (SDL_JoystickFromInstanceID(evt.jdevice.which) == joy1) {
-                    SDL_JoystickClose(joy1);
-                    joy1 = null;
-                } else if (SDL_JoystickFromInstanceID(evt.jdevice.which) == joy2) {
-                    SDL_JoystickClose(joy2);
-                    joy2 = null;
-                };
-            };
-        };
-    };
-
-    // update joysticks
-    void update(SDL_Joystick* joy1, SDL_Joystick* joy2) {
-        SDL_JoystickUpdate();
-        m_keys1 = 0x000;
-        m_keys2 = 0x000;
-
-        // update keys from keyboard
-        m_keys1 |= m_keystate[SDL_SCANCODE_DOWN] << 0;
-        m_keys1 |= m_keystate[SDL_SCANCODE_UP] << 1;
-        m_keys1 |= m_keystate[SDL_SCANCODE_RIGHT] << 2;
-        m_keys1 |= m_keystate[SDL_SCANCODE_LEFT] << 3;
-        m_keys1 |= m_keystate[SDL_SCANCODE_A] << 4;
-        m_keys1 |= m_keystate[SDL_SCANCODE_S] << 5;
-        m_keys1 |= m_keystate[SDL_SCANCODE_Z] << 6;
-        m_keys1 |= m_keystate[SDL_SCANCODE_X] << 7;
-        m_keys1 |= m_keystate[SDL_SCANCODE_W] << 8;
-        m_keys1 |= m_keystate[SDL_SCANCODE_Q] << 9;
-        m_keys1 |= m_keystate[SDL_SCANCODE_RETURN] << 10;
-        m_keys1 |= m_keystate[SDL_SCANCODE_SPACE] << 11;
-
-        // update keys from joystick
-        if (joy1) {
-            Sint16 x = SDL_JoystickGetAxis(joy1, 0);
-            Sint16 y = SDL_JoystickGetAxis(joy1, 1);
-
-            m_keys1 |= (y >= 8192) << 0;
-            m_keys1 |= (y <= -8192) << 1;
-            m_keys1 |= (x >= 8192) << 2;
-            m_keys1 |= (x <= -8192) << 3;
-
-            m_keys1 |= SDL_JoystickGetButton(joy1, 3) << 4;
-            m_keys1 |= SDL_JoystickGetButton(joy1, 0) << 5;
-            m_keys1 |= SDL_JoystickGetButton(joy1, 2) << 6;
-            m_keys1 |= SDL_JoystickGetButton(joy1, 1) << 7;
-            m_keys1 |= (SDL_JoystickGetButton(joy1, 5) | SDL_JoystickGetButton(joy1, 7)) << 8;
-            m_keys1 |= (SDL_JoystickGetButton(joy1, 4) | SDL_JoystickGetButton(joy1, 6)) << 9;
-            m_keys1 |= SDL_JoystickGetButton(joy1, 9) << 10;
-            m_keys1 |= SDL_JoystickGetButton(joy1, 8) << 11;
-        };
-        if (joy2) {
-            Sint16 x = SDL_JoystickGetAxis(joy2, 0);
-            Sint16 y = SDL_JoystickGetAxis(joy2, 1);
-
-            m_keys2 |= (y >= 8192) << 0;
-            m_keys2 |= (y <= -8192) << 1;
-            m_keys2 |= (x >= 8192) << 2;
-            m_keys2 |= (x <= -8192) << 3;
-
-            m_keys2 |= SDL_JoystickGetButton(joy2, 3) << 4;
-            m_keys2 |= SDL_JoystickGetButton(joy2, 0) << 5;
-            m_keys2 |= SDL_JoystickGetButton(joy2, 2) << 6;
-            m_keys2 |= SDL_JoystickGetButton(joy2, 1) << 7;
-            m_keys2 |= (SDL_JoystickGetButton(joy2, 5) | SDL_JoystickGetButton(joy2, 7)) << 8;
-            m_keys2 |= (SDL_JoystickGetButton(joy2, 4) | SDL_JoystickGetButton(joy2, 6)) << 9;
-            m_keys2 |= SDL_JoystickGetButton(joy2, 9) << 10;
-            m_keys2 |= SDL_JoystickGetButton(joy2, 8) << 11;
-        };
-    };
-
-    // window render
-    void render(inpf get) {
-        // sort sprites by layer
-        vec<Sprite*>sorted[3];
-        for (int i = 0; i < 128; i++) {
-            Sprite& spr = sprites[i];
-
-            if (spr.layer() == 0) {
-                sorted[0].push_back(&spr);
-            } else if (spr.layer() == 1) {
-                sorted[1].push_back(&spr);
-            } else {
-                sorted[2].push_back(&spr);
-            };
-        };
-
-        // dma sprite data
-        if (sprb) {
-            for (int i = 0; i < 128; i++) {
-                sprites[i].p3 = get(saddr + i * 2 + 0x000);
-                sprites[i].p4 = get(saddr + i * 2 + 0x001);
-                sprites[i].p5 = get(saddr + i * 2 + 0x100);
-                sprites[i].p6 = get(saddr + i * 2 + 0x101);
-                sprites[i].p1 = get(saddr + i * 2 + 0x200);
-                sprites[i].p2 = get(saddr + i * 2 + 0x201);
-            };
-        };
-
-        // check scrolls
-        layers[0].scrollx %= 320;
-        layers[0].scrolly %= 240;
-        layers[1].scrollx %= 320;
-        layers[1].scrolly %= 240;
-
-        // render screen
-        SDL_Surface* tgt = SDL_CreateRGBSurface(0, 320, 240, m_scr->format->BitsPerPixel, m_scr->format->Rmask, m_scr->format->Gmask, m_scr->format->Bmask, m_scr->format->Amask);
-        SDL_FillRect(tgt, null, SDL_MapRGBA(m_scr->format, m_pal[0]->colors[0].r, m_pal[0]->colors[0].g, m_pal[0]->colors[0].b, m_pal[0]->colors[0].a));
-        if (sprb) {
-            renderSprites(sorted[0]);
-            SDL_BlitSurface(m_buf, null, tgt, null);
-        };
-        if (lay1) {
-            renderLayer(layers[0]);
-            SDL_BlitSurface(m_buf, null, tgt, null);
-        };
-        if (sprb) {
-            renderSprites(sorted[1]);
-            SDL_BlitSurface(m_buf, null, tgt, null);
-        };
-        if (lay2) {
-            renderLayer(layers[1]);
-            SDL_BlitSurface(m_buf, null, tgt, null);
-        };
-        if (sprb) {
-            renderSprites(sorted[2]);
-            SDL_BlitSurface(m_buf, null, tgt, null);
-        };
-        SDL_BlitScaled(tgt, null, m_scr, null);
-        SDL_UpdateWindowSurface(m_win);
-        SDL_FreeSurface(tgt);
-    };
-
-    // layer render
-    void renderLayer(Layer& layer) {
-        int sx = layer.scrollx + layer.roomx * 320;
-        int sy = layer.scrolly + layer.roomy * 240;
-
-        for (int y = 0; y < 31; y++) {
-            for (int x = 0; x < 41; x++) {
-                int tx = (x + (sx >> 3)) % 80;
-                int ty = (y + (sy >> 3)) % 60;
-                Tile& tile = layer.data[toRoom(tx, ty)][toIndex(tx, ty)];
-
-                SDL_Rect src = {tile.id() << 3, 0, 8, 8};
-                SDL_Rect dst = {(x << 3) - (sx & 7), (y << 3) - (sy & 7), 8, 8};
-
-                SDL_SetSurfacePalette(m_sur, m_pal[tile.palette()]);
-                SDL_BlitSurface(m_sur, &src, m_buf, &dst);
-            };
-        };
-    };
-
-    // sprites render
-    void renderSprites(vec<Sprite*> sprites) {
-        for (Sprite* spr : sprites) {
-            SDL_Rect src = {(spr->id() | (sprc ? 0x400 : 0)) << 3, 0, 8, 8};
-            SDL_Rect dst = {spr->x(), spr->y(), 8, 8};
-
-            SDL_SetSurfacePalette(m_sur, m_pal[spr->palette()]);
-            SDL_BlitSurface(m_sur, &src, m_buf, &dst);
-        };
-    };
-
-    // fps capper
-    void start() {
-        m_timer = SDL_GetTicks();
-    };
-    void stop(proc action) {
-        while (true) {
-            int delta = SDL_GetTicks() - m_timer;
-            action();
-            if (delta >= 16)
-                break;
-        };
-    };
-
-    // is window active
-    bool running() {
-        return m_run;
-    };
-    // check nmi
-    bool nmi() {
-        return nmib;
-    };
-
-    // get key state
-    wt keys1() {
-        return m_keys1 | (m_ju << 15);
-    };
-    wt keys2() {
-        return m_keys2 | (m_ju << 15);
-    };
-    void setJoystickUse(bool state) {
-        m_ju = state;
-    };
-
-    // get layer
-    Layer& layer(bool id) {
-        return layers[id];
-    };
-    // get sprite reference
-    Sprite& sprite(bt id) {
-        return sprites[id & 0x7F];
-    };
-    // get cgram reference
-    SDL_Surface* cgram() {
-        return m_sur;
-    };
-    // get palette color
-    SDL_Color& palette(bt id) {
-        return m_pal[id >> 4]->colors[id & 0xF];
-    };
-
-    // registers
-    void spriteAddr(bt data) {
-        saddr >>= 8;
-        saddr |= data << 8;
-    };
-    void vramAddr(bt data) {
-        vaddr >>= 8;
-        vaddr |= data << 8;
-    };
-    void scroll(bt data, bt id) {
-        switch (id) {
-            case 0:
-            layers[0].scrollx >>= 8;
-            layers[0].scrollx |= data << 8;
-            break;
-            case 1:
-            layers[0].scrolly >>= 8;
-            layers[0].scrolly |= data << 8;
-            break;
-            case 2:
-            layers[1].scrollx >>= 8;
-            layers[1].scrollx |= data << 8;
-            break;
-            case 3:
-            layers[1].scrolly >>= 8;
-            layers[1].scrolly |= data << 8;
-            break;
-        };
-    };
-
-    // I/O
-    void write(bt data) {
-        wt addr = vaddr;
-
-        if (addr >= 0x8000) {
-            switch (head & 0x3) {
-                case 0:
-                vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) + 1, 1200);
-                break;
-                case 1:
-                vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) - 1, 1200);
-                break;
-                case 2: {
-                    if ((vaddr & 0x7FF) == 0x4AF) {
-                        vaddr = vaddr & 0xF800;
-                        break;
-                    };
-                    vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) + 40, 1200);
-                    if (addr > vaddr) vaddr++;
-                };
-                break;
-                case 3: {
-                    if ((vaddr & 0x7FF) == 0) {
-                        vaddr = (vaddr & 0xF800) | 0x4AF;
-                        break;
-                    };
-                    vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) - 40, 1200);
-                    if (addr < vaddr) vaddr--;
-                };
-                break;
-            };
-
-            bt block = (addr >> 11) & 0xF;
-            wt offset = addr & 0x7FF;
-
-            if (offset < 1200) {
-                wt xc = offset % 40;
-                wt yc = offset / 40;
-
-                if (block >> 3)
-                    layers[(block >> 2) & 1].data[block & 3][yc * 40 + xc].p2 = data;
-                else
-                    layers[(block >> 2) & 1].data[block & 3][yc * 40 + xc].p1 = data;
-            };
-            return;
-        };
-        vaddr++;
-
-        if (addr < 0x200) {
-            bt id = addr >> 1;
-
-            if (addr & 1) {
-                palette(id).b = (data >> 4) * 0x11;
-                palette(id).a = (data & 15) * 0x11;
-            } else {
-                palette(id).r = (data >> 4) * 0x11;
-                palette(id).g = (data & 15) * 0x11;
-            };
-        };
-    };
-    bt read() {
-        wt addr = vaddr;
-
-        if (addr >= 0x8000) {
-            switch (head & 0x3) {
-                case 0:
-                vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) + 1, 1200);
-                break;
-                case 1:
-                vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) - 1, 1200);
-                break;
-                case 2: {
-                    if ((vaddr & 0x7FF) == 0x4AF) {
-                        vaddr = vaddr & 0xF800;
-                        break;
-                    };
-                    vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) + 40, 1200);
-                    if (addr > vaddr) vaddr++;
-                };
-                break;
-                case 3: {
-                    if ((vaddr & 0x7FF) == 0) {
-                        vaddr = (vaddr & 0xF800) | 0x4AF;
-                        break;
-                    };
-                    vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) - 40, 1200);
-                    if (addr < vaddr) vaddr--;
-                };
-                break;
-            };
-
-            bt block = (addr >> 11) & 0xF;
-            wt offset = addr & 0x7FF;
-
-            if (offset < 1200) {
-                wt xc = offset % 40;
-                wt yc = offset / 40;
-
-                if (block >> 3)
-                    return layers[(block >> 2) & 1].data[block & 3][yc * 40 + xc].p2;
-                return layers[(block >> 2) & 1].data[block & 3][yc * 40 + xc].p1;
-            };
-            return 0;
-        };
-        vaddr++;
-
-        return 0;
-    };
-    void control(bt data) {
-        nmib = data & 0x80;
-        sprb = data & 0x40;
-        lay1 = data & 0x20;
-        lay2 = data & 0x10;
-        sprc = data & 0x04;
-        head = data & 0x03;
-    };
-    void room(bt data) {
-        layers[0].roomy = data & 0x8;
-        layers[0].roomx = data & 0x4;
-        layers[1].roomy = data & 0x2;
-        layers[1].roomx = data & 0x1;
-    };
-
-    private:
-    // window control
-    SDL_Palette*  m_pal[16];
-    SDL_Surface*  m_scr;
-    SDL_Surface*  m_buf;
-    SDL_Surface*  m_sur;
-    SDL_Window*   m_win;
-    const Uint8* m_keystate;
-    bool m_run = false;
-    bool m_ju = false;
-    dt m_timer = 0;
-    wt m_keys1 = 0;
-    wt m_keys2 = 0;
-    bt m_scale = 1;
-
-    // gpu data
-    Layer layers[2];
-    Sprite sprites[128];
-    wt vaddr;
-    wt saddr;
-    bt head;
-    bool nmib;
-    bool sprb;
-    bool lay1;
-    bool lay2;
-    bool sprc;
-};
+// -- engine -- //
+
+// key codes
+#define KEY_DOWN   0x001
+#define KEY_UP     0x002
+#define KEY_RIGHT  0x004
+#define KEY_LEFT   0x008
+#define KEY_Y      0x010
+#define KEY_X      0x020
+#define KEY_B      0x040
+#define KEY_A      0x080
+#define KEY_R      0x100
+#define KEY_L      0x200
+#define KEY_START  0x400
+#define KEY_SELECT 0x800
+
+// frame timing
+const int lineCount = 262;
+const int blankLines = 22;
+const int lineCheck = 32;
+const int lineBudget = 1024;
+
+// turbo presentation
+const Uint64 presentRate = 60;
+const Uint64 titleUpdate = 500000000;
+
+// icon data
+const Uint16 g1 = 0xF334;
+const Uint16 g2 = 0xF223;
+const Uint16 g3 = 0xF112;
+const Uint16 p1 = 0xF9AB;
+const Uint16 b1 = 0x1000;
+const Uint16 b2 = 0x2000;
+
+Uint16 iconData[256] {
+    b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2,
+    b2, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
+    b2, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
+
+    b2, b1, b1, b1, g1, g1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
+    b2, b1, g1, g1, g1, g1, g1, g1, b1, b1, b1, b1, b1, b1, b1, b2,
+    b2, g1, g1, g1, g1, g1, g1, g1, g1, g1, b1, b1, b1, b1, b1, b2,
+    b2, g2, g1, g1, g1, g1, g1, g1, g1, g1, g1, g1, b1, b1, b1, b2,
+    b2, g2, g2, p1, g1, g1, g1, g1, g1, g1, g1, g1, g1, g1, b1, b2,
+    b2, b1, g2, p1, g2, p1, g1, g1, g1, g1, g1, g1, g1, g1, g1, b2,
+    b2, b1, p1, b1, g2, p1, g2, p1, g1, g1, g1, g1, g1, g1, g3, b2,
+    b2, b1, b1, b1, p1, b1, g2, p1, g2, p1, g1, g1, g3, g3, g3, b2,
+    b2, b1, b1, b1, b1, b1, p1, b1, g2, p1, g3, g3, g3, g3, b1, b2,
+    b2, b1, b1, b1, b1, b1, b1, b1, p1, b1, g3, g3, b1, b1, b1, b2,
+
+    b2, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
+    b2, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b1, b2,
+    b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2, b2
+};
+
+// triple buffer state
+const int frameFresh = 4;
+
+// saved video state
+struct Snapshot {
+    Layer layers[2];
+    Sprite sprites[128];
+    Uint32 argb[256];
+    wt vaddr;
+    wt saddr;
+    bt head;
+    bool nmib;
+    bool sprb;
+    bool lay1;
+    bool lay2;
+    bool sprc;
+    wt held1;
+    wt held2;
+    dt frames;
+    Uint64 first;
+    Uint64 lines;
+};
+
+// gpu object
+class GPU {
+    public:
+    // window creator
+    bool create(st name, int width, int height) {
+        // create window
+        m_win = SDL_CreateWindow(name, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, width, height, SDL_WINDOW_SHOWN);
+        if (m_win == null) return false;
+        m_name = name;
+
+        // create surfaces
+        m_sur = SDL_CreateRGBSurfaceWithFormat(0, 16384, 8, 8, SDL_PIXELFORMAT_INDEX8);
+        if (m_sur == null) return false;
+
+        // prefer streaming texture presentation
+        m_ren = SDL_CreateRenderer(m_win, -1, SDL_RENDERER_ACCELERATED);
+        if (m_ren == null || !resize()) {
+            if (m_ren) SDL_DestroyRenderer(m_ren);
+            m_ren = null;
+            m_scr = SDL_GetWindowSurface(m_win);
+        };
+        m_expand = expander();
+
+        // set window icon
+        SDL_Surface* ico = SDL_CreateRGBSurfaceFrom(iconData, 16, 16, 16, 32, 0x0F00, 0x00F0, 0x000F, 0xF000);
+        SDL_SetWindowIcon(m_win, ico);
+        SDL_FreeSurface(ico);
+        return setup();
+    };
+    bool createHeadless(Uint32* pixels = null) {
+        // offscreen surfaces only
+        m_sur = SDL_CreateRGBSurfaceWithFormat(0, 16384, 8, 8, SDL_PIXELFORMAT_INDEX8);
+        if (m_sur == null) return false;
+        return setup(pixels);
+    };
+
+    // shared device state
+    bool setup(Uint32* pixels = null) {
+        // create frame buffers, unpublished frames can render into caller memory
+        for (int i = 0; i < 3; i++) {
+            if (pixels)
+                m_frame[i] = SDL_CreateRGBSurfaceWithFormatFrom(pixels, 320, 240, 32, 320 * 4, SDL_PIXELFORMAT_ARGB8888);
+            else
+                m_frame[i] = SDL_CreateRGBSurfaceWithFormat(0, 320, 240, 32, SDL_PIXELFORMAT_ARGB8888);
+            if (m_frame[i] == null) return false;
+            SDL_SetSurfaceBlendMode(m_frame[i], SDL_BLENDMODE_NONE);
+        };
+        m_ready = SDL_CreateSemaphore(0);
+        m_swap = 1;
+        m_back = 0;
+        m_front = 2;
+
+        // select line compositor
+        m_compose = composer();
+
+        // create palettes
+        for (int i = 0; i < 16; i++)
+            m_pal[i] = SDL_AllocPalette(16);
+
+        // power cycle
+        power();
+        nmib = false;
+        head = 0;
+
+        // success
+        m_keystate = SDL_GetKeyboardState(null);
+        m_keys1 = 0x000;
+        m_keys2 = 0x000;
+        m_input = 0;
+        m_reset = false;
+        m_run = true;
+        return true;
+    };
+
+    // destructor
+    ~GPU () {
+        if (m_tex) SDL_DestroyTexture(m_tex);
+        if (m_ren) SDL_DestroyRenderer(m_ren);
+        if (m_ready) SDL_DestroySemaphore(m_ready);
+        if (m_sur) SDL_FreeSurface(m_sur);
+        for (int i = 0; i < 3; i++) {
+            if (m_frame[i]) SDL_FreeSurface(m_frame[i]);
+        };
+        for (int i = 0; i < 16; i++) {
+            if (m_pal[i]) SDL_FreePalette(m_pal[i]);
+        };
+
+        // only the windowed console owns the sdl session, headless and batch ones leave it up
+        if (m_win) {
+            SDL_DestroyWindow(m_win);
+            SDL_Quit();
+        };
+    };
+
+    // power cycle
+    void power() {
+        // randomize initial state
+        for (int i = 0; i < 16; i++) {
+            SDL_Color colors[16];
+            for (int j = 0; j < 16; j++) {
+                colors[j].r = 0x0;
+                colors[j].g = 0x0;
+                colors[j].b = 0x0;
+                colors[j].a = 0x0;
+            };
+            SDL_SetPaletteColors(m_pal[i], colors, 0, 16);
+        };
+        for (int i = 0; i < 256; i++)
+            m_argb[i] = 0x00000000;
+        for (int l = 0; l < 2; l++) {
+            for (int r = 0; r < 4; r++) {
+                for (int i = 0; i < 1200; i++) {
+                    layers[l].data[r][i].p1 = 0x0;
+                    layers[l].data[r][i].p2 = 0x0;
+                };
+            };
+        };
+        invalidate();
+        for (int i = 0; i < 128; i++) {
+            sprites[i].p1 = 0x0;
+            sprites[i].p2 = 0x0;
+            sprites[i].p3 = 0x0;
+            sprites[i].p4 = 0x0;
+            sprites[i].p5 = 0x0;
+            sprites[i].p6 = 0x0;
+        };
+    };
+
+    // event handler
+    void events(SDL_Joystick*& joy1, SDL_Joystick*& joy2) {
+        SDL_Event evt;
+
+        // handler loop
+        while (SDL_PollEvent(&evt)) {
+            // quit event
+            if (evt.type == SDL_QUIT) {
+                m_run = false;
+                return;
+            };
+            // key press
+            if (evt.type == SDL_KEYDOWN) {
+                // reset console
+                if (evt.key.keysym.sym == SDLK_r) {
+                    m_reset = true;
+                    continue;
+                };
+
+                // change window scale
+                if (evt.key.keysym.sym == SDLK_f) {
+                    m_scale = (m_scale + 1) & 3;
+                    SDL_SetWindowSize(m_win, 320 * (m_scale + 1), 240 * (m_scale + 1));
+                    if (m_ren)
+                        resize();
+                    else
+                        m_scr = SDL_GetWindowSurface(m_win);
+                    continue;
+                };
+
+                // toggle smoothing filter
+                if (evt.key.keysym.sym == SDLK_g) {
+                    m_smooth = !m_smooth;
+                    continue;
+                };
+
+                // cycle audio interpolation
+                if (evt.key.keysym.sym == SDLK_h) {
+                    m_filter++;
+                    continue;
+                };
+
+                // toggle turbo mode
+                if (evt.key.keysym.sym == SDLK_TAB) {
+                    m_turbo = !m_turbo;
+                    continue;
+                };
+
+                // toggle telemetry overlay
+                if (evt.key.keysym.sym == SDLK_t) {
+                    telemetry.toggle();
+                    continue;
+                };
+                continue;
+            };
+            // joystick events
+            if (evt.type == SDL_JOYDEVICEADDED) {
+                if (joy1) {
+                    if (!joy2)
+                        joy2 = SDL_JoystickOpen(evt.jdevice.which);
+                } else {
+                    joy1 = SDL_JoystickOpen(evt.jdevice.which);
+                };
+            };
+            if (evt.type == SDL_JOYDEVICEREMOVED) {
+                if (SDL_JoystickFromInstanceID(evt.jdevice.which) == joy1) {
+                    SDL_JoystickClose(joy1);
+                    joy1 = null;
+                } else if (SDL_JoystickFromInstanceID(evt.jdevice.which) == joy2) {
+                    SDL_JoystickClose(joy2);
+                    joy2 = null;
+                };
+            };
+        };
+    };
+
+    // update joysticks
+    void update(SDL_Joystick* joy1, SDL_Joystick* joy2) {
+        SDL_JoystickUpdate();
+        m_keys1 = 0x000;
+        m_keys2 = 0x000;
+
+        // update keys from keyboard
+        m_keys1 |= m_keystate[SDL_SCANCODE_DOWN] << 0;
+        m_keys1 |= m_keystate[SDL_SCANCODE_UP] << 1;
+        m_keys1 |= m_keystate[SDL_SCANCODE_RIGHT] << 2;
+        m_keys1 |= m_keystate[SDL_SCANCODE_LEFT] << 3;
+        m_keys1 |= m_keystate[SDL_SCANCODE_A] << 4;
+        m_keys1 |= m_keystate[SDL_SCANCODE_S] << 5;
+        m_keys1 |= m_keystate[SDL_SCANCODE_Z] << 6;
+        m_keys1 |= m_keystate[SDL_SCANCODE_X] << 7;
+        m_keys1 |= m_keystate[SDL_SCANCODE_W] << 8;
+        m_keys1 |= m_keystate[SDL_SCANCODE_Q] << 9;
+        m_keys1 |= m_keystate[SDL_SCANCODE_RETURN] << 10;
+        m_keys1 |= m_keystate[SDL_SCANCODE_SPACE] << 11;
+
+        // update keys from joystick
+        if (joy1) {
+            Sint16 x = SDL_JoystickGetAxis(joy1, 0);
+            Sint16 y = SDL_JoystickGetAxis(joy1, 1);
+
+            m_keys1 |= (y >= 8192) << 0;
+            m_keys1 |= (y <= -8192) << 1;
+            m_keys1 |= (x >= 8192) << 2;
+            m_keys1 |= (x <= -8192) << 3;
+
+            m_keys1 |= SDL_JoystickGetButton(joy1, 3) << 4;
+            m_keys1 |= SDL_JoystickGetButton(joy1, 0) << 5;
+            m_keys1 |= SDL_JoystickGetButton(joy1, 2) << 6;
+            m_keys1 |= SDL_JoystickGetButton(joy1, 1) << 7;
+            m_keys1 |= (SDL_JoystickGetButton(joy1, 5) | SDL_JoystickGetButton(joy1, 7)) << 8;
+            m_keys1 |= (SDL_JoystickGetButton(joy1, 4) | SDL_JoystickGetButton(joy1, 6)) << 9;
+            m_keys1 |= SDL_JoystickGetButton(joy1, 9) << 10;
+            m_keys1 |= SDL_JoystickGetButton(joy1, 8) << 11;
+        };
+        if (joy2) {
+            Sint16 x = SDL_JoystickGetAxis(joy2, 0);
+            Sint16 y = SDL_JoystickGetAxis(joy2, 1);
+
+            m_keys2 |= (y >= 8192) << 0;
+            m_keys2 |= (y <= -8192) << 1;
+            m_keys2 |= (x >= 8192) << 2;
+            m_keys2 |= (x <= -8192) << 3;
+
+            m_keys2 |= SDL_JoystickGetButton(joy2, 3) << 4;
+            m_keys2 |= SDL_JoystickGetButton(joy2, 0) << 5;
+            m_keys2 |= SDL_JoystickGetButton(joy2, 2) << 6;
+            m_keys2 |= SDL_JoystickGetButton(joy2, 1) << 7;
+            m_keys2 |= (SDL_JoystickGetButton(joy2, 5) | SDL_JoystickGetButton(joy2, 7)) << 8;
+            m_keys2 |= (SDL_JoystickGetButton(joy2, 4) | SDL_JoystickGetButton(joy2, 6)) << 9;
+            m_keys2 |= SDL_JoystickGetButton(joy2, 9) << 10;
+            m_keys2 |= SDL_JoystickGetButton(joy2, 8) << 11;
+        };
+
+        // publish to emulation thread
+        m_input = m_keys1 | m_keys2 << 16;
+    };
+
+    // take live requests at frame start
+    Input poll() {
+        Input in;
+        in.keys = m_input;
+        in.reset = m_reset.exchange(false);
+        return in;
+    };
+    // latch requests for this frame
+    void latch(CPU& cpu, Input in) {
+        m_held1 = in.keys & 0xFFFF;
+        m_held2 = in.keys >> 16;
+
+        if (in.reset)
+            vectorRST(cpu);
+    };
+
+    // frame render
+    void render(inpf get, stepf action) {
+        // vertical blank runs the nmi handler
+        for (int line = 0; line < blankLines; line++)
+            runLine(line, action);
+        lap(PHASE_NMI);
+
+        // dma sprite data
+        if (sprb)
+            dma(get);
+        if (m_draw)
+            binSprites();
+        lap(PHASE_DMA);
+
+        // render screen between cpu slices
+        for (int y = 0; y < 240; y++) {
+            runLine(blankLines + y, action);
+            lap(PHASE_CPU);
+            if (m_draw)
+                renderLine(y);
+        };
+    };
+
+    // sprite attribute transfer
+    void dma(inpf get) {
+        // bulk copy from ram
+        if (m_ram && saddr + 0x300 <= 0x4000) {
+            bt* pos = m_ram + saddr;
+            bt* size = pos + 0x100;
+            bt* tile = pos + 0x200;
+
+            for (int i = 0; i < 128; i++) {
+                sprites[i].p3 = pos[i * 2 + 0];
+                sprites[i].p4 = pos[i * 2 + 1];
+                sprites[i].p5 = size[i * 2 + 0];
+                sprites[i].p6 = size[i * 2 + 1];
+                sprites[i].p1 = tile[i * 2 + 0];
+                sprites[i].p2 = tile[i * 2 + 1];
+            };
+            return;
+        };
+
+        // read through memory map
+        for (int i = 0; i < 128; i++) {
+            sprites[i].p3 = get(saddr + i * 2 + 0x000);
+            sprites[i].p4 = get(saddr + i * 2 + 0x001);
+            sprites[i].p5 = get(saddr + i * 2 + 0x100);
+            sprites[i].p6 = get(saddr + i * 2 + 0x101);
+            sprites[i].p1 = get(saddr + i * 2 + 0x200);
+            sprites[i].p2 = get(saddr + i * 2 + 0x201);
+        };
+    };
+
+    // sort sprites by layer and scanline
+    void binSprites() {
+        for (int l = 0; l < 3; l++) {
+            for (int y = 0; y < 240; y++)
+                m_binCount[l][y] = 0;
+        };
+
+        for (int i = 0; i < 128; i++) {
+            bt layer = sprites[i].layer();
+            int top = sprites[i].y();
+            if (layer > 2) layer = 2;
+
+            for (int y = top < 0 ? 0 : top; y < top + 8 && y < 240; y++)
+                m_bins[layer][y][m_binCount[layer][y]++] = i;
+        };
+    };
+
+    // hand finished frame to presentation
+    void publish() {
+        if (!m_draw)
+            return;
+
+        // adapt turbo frame skip to present rate
+        if (m_turbo) {
+            Uint64 time = Pacer::now();
+            Uint64 target = 1000000000ull / presentRate;
+            Uint64 ideal = target * m_skip / (time - m_shown + 1);
+            m_skip = (m_skip + (ideal ? ideal : 1) + 1) / 2;
+            m_shown = time;
+        };
+
+        m_back = m_swap.exchange(m_back | frameFresh) & 3;
+        SDL_SemPost(m_ready);
+    };
+
+    // show emulation speed
+    void status() {
+        Uint64 time = Pacer::now();
+        if (time - m_titleTime < titleUpdate)
+            return;
+
+        dt frames = m_frames;
+        if (m_titleTime == 0) {
+            m_titleTime = time;
+            m_titleFrames = frames;
+            return;
+        };
+        double speed = double(frames - m_titleFrames) * 1000000000.0 / (time - m_titleTime) / frameRate;
+        m_titleTime = time;
+        m_titleFrames = frames;
+
+        char title[64];
+        if (m_turbo)
+            snprintf(title, sizeof(title), "%s - Turbo %.1fx", m_name, speed);
+        else
+            snprintf(title, sizeof(title), "%s", m_name);
+        SDL_SetWindowTitle(m_win, title);
+    };
+
+    // present newest frame
+    bool present() {
+        // scaler scratch, only the window presents so consoles share it
+        static Uint32 temp[640 * 480];
+        if (!(m_swap & frameFresh))
+            return false;
+
+        m_front = m_swap.exchange(m_front) & 3;
+        SDL_Surface* frame = m_frame[m_front];
+        int factor = m_scale + 1;
+        if (telemetry.shown())
+            telemetry.draw(frame);
+        bool timed = telemetry.active();
+        Uint64 mark = timed ? Pacer::now() : 0;
+
+        // streaming texture path
+        if (m_ren) {
+            void* pixels;
+            int pitch;
+            if (SDL_LockTexture(m_tex, null, &pixels, &pitch) == 0) {
+                scaleFrame(m_expand, m_smooth, frame, pixels, pitch, factor, temp);
+                SDL_UnlockTexture(m_tex);
+            };
+            if (timed)
+                mark = hostLap(PHASE_SCALE, mark);
+            SDL_RenderCopy(m_ren, m_tex, null, null);
+            SDL_RenderPresent(m_ren);
+            if (timed)
+                hostLap(PHASE_PRESENT, mark);
+            return true;
+        };
+
+        // software window surface path
+        SDL_PixelFormat* fmt = m_scr->format;
+        if (fmt->BytesPerPixel == 4 && fmt->Rmask == 0xFF0000 && fmt->Bmask == 0xFF && m_scr->w >= 320 * factor && m_scr->h >= 240 * factor) {
+            SDL_LockSurface(m_scr);
+            scaleFrame(m_expand, m_smooth, frame, m_scr->pixels, m_scr->pitch, factor, temp);
+            SDL_UnlockSurface(m_scr);
+        } else {
+            SDL_BlitScaled(frame, null, m_scr, null);
+        };
+        if (timed)
+            mark = hostLap(PHASE_SCALE, mark);
+        SDL_UpdateWindowSurface(m_win);
+        if (timed)
+            hostLap(PHASE_PRESENT, mark);
+        return true;
+    };
+
+    // charge time since last mark to phase
+    void lap(Phase phase) {
+        if (!m_probing)
+            return;
+        Uint64 time = Pacer::now();
+        m_sample.time[phase] += time - m_mark;
+        m_mark = time;
+
+        // host cycles spent executing
+        Uint64 tsc = __rdtsc();
+        if (phase == PHASE_CPU || phase == PHASE_NMI)
+            m_sample.cycles += tsc - m_tsc;
+        m_tsc = tsc;
+    };
+    Uint64 hostLap(Phase phase, Uint64 mark) {
+        Uint64 time = Pacer::now();
+        telemetry.host(phase, time - mark);
+        return time;
+    };
+
+    // recreate output texture
+    bool resize() {
+        if (m_tex)
+            SDL_DestroyTexture(m_tex);
+
+        int factor = m_scale + 1;
+        m_tex = SDL_CreateTexture(m_ren, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 320 * factor, 240 * factor);
+        return m_tex != null;
+    };
+
+    // wait for next frame
+    void wait(int ms) {
+        SDL_SemWaitTimeout(m_ready, ms);
+    };
+
+    // run cpu until end of line slot
+    void runLine(int line, stepf action) {
+        m_lines = m_first + line;
+
+        // fixed instruction budget instead of wall clock, turbo never waits for deadlines
+        dt budget = m_budget ? m_budget : m_turbo ? lineBudget : 0;
+        if (budget) {
+            for (dt i = 0; i < budget; i++) {
+                if (!action()) {
+                    m_retired += i + 1;
+                    return;
+                };
+            };
+            m_retired += budget;
+            return;
+        };
+
+        Uint64 deadline = m_pace.at(line + 1, lineCount);
+        while (Pacer::now() < deadline) {
+            for (int i = 0; i < lineCheck; i++) {
+                // nothing changes until next frame
+                if (!action()) {
+                    m_retired += i + 1;
+                    return;
+                };
+            };
+            m_retired += lineCheck;
+        };
+    };
+
+    // scanline render
+    void renderLine(int y) {
+        SDL_Surface* buf = m_frame[m_back];
+        Uint32* line = (Uint32*)((Uint8*)buf->pixels + buf->pitch * y);
+        const Uint32* passes[5];
+        int count = 0;
+
+        // update layer bitmaps
+        if (lay1 && (!m_valid[0] || m_dirtyCount[0])) refresh(0);
+        if (lay2 && (!m_valid[1] || m_dirtyCount[1])) refresh(1);
+
+        // fill layer line buffers
+        if (sprb && m_binCount[0][y]) {
+            lap(PHASE_LAYERS);
+            renderSprites(0, y, m_line[0]);
+            passes[count++] = m_line[0];
+            lap(PHASE_SPRITES);
+        };
+        if (lay1) {
+            renderLayer(0, y, m_line[1]);
+            passes[count++] = m_line[1];
+        };
+        if (sprb && m_binCount[1][y]) {
+            lap(PHASE_LAYERS);
+            renderSprites(1, y, m_line[2]);
+            passes[count++] = m_line[2];
+            lap(PHASE_SPRITES);
+        };
+        if (lay2) {
+            renderLayer(1, y, m_line[3]);
+            passes[count++] = m_line[3];
+        };
+        if (sprb && m_binCount[2][y]) {
+            lap(PHASE_LAYERS);
+            renderSprites(2, y, m_line[4]);
+            passes[count++] = m_line[4];
+            lap(PHASE_SPRITES);
+        };
+        lap(PHASE_LAYERS);
+
+        // merge over backdrop color
+        m_compose(line, m_argb[0] | 0xFF000000, passes, count, 320);
+        lap(PHASE_COMPOSE);
+    };
+
+    // layer line render
+    void renderLayer(int id, int y, Uint32* out) {
+        Layer& layer = layers[id];
+        int sx = layer.scrollx % 320 + layer.roomx * 320;
+        int sy = (layer.scrolly % 240 + layer.roomy * 240 + y) % 480;
+        bt* row = m_cache[id][sy];
+
+        // wrapped copy from layer bitmap
+        int first = 640 - sx < 320 ? 640 - sx : 320;
+        for (int x = 0; x < first; x++)
+            out[x] = m_argb[row[sx + x]];
+        for (int x = first; x < 320; x++)
+            out[x] = m_argb[row[x - first]];
+    };
+
+    // redraw changed layer tiles
+    void refresh(int id) {
+        if (!m_valid[id]) {
+            for (int r = 0; r < 4; r++) {
+                for (int i = 0; i < 1200; i++)
+                    drawTile(id, r, i);
+            };
+            m_valid[id] = true;
+        } else {
+            for (int n = 0; n < m_dirtyCount[id]; n++) {
+                wt cell = m_dirtyList[id][n];
+                drawTile(id, cell / 1200, cell % 1200);
+            };
+        };
+
+        // clear dirty cells
+        for (int n = 0; n < m_dirtyCount[id]; n++)
+            m_dirty[id][m_dirtyList[id][n]] = false;
+        m_dirtyCount[id] = 0;
+    };
+
+    // draw tile into layer bitmap
+    void drawTile(int id, int room, int index) {
+        Tile& tile = layers[id].data[room][index];
+        int px = ((room & 1) * 40 + index % 40) << 3;
+        int py = ((room >> 1) * 30 + index / 40) << 3;
+        bt pal = tile.palette() << 4;
+
+        for (int y = 0; y < 8; y++) {
+            Uint8* src = (Uint8*)m_sur->pixels + m_sur->pitch * y + (tile.id() << 3);
+            bt* dst = m_cache[id][py + y] + px;
+
+            for (int x = 0; x < 8; x++)
+                dst[x] = pal | src[x];
+        };
+    };
+
+    // mark tile as changed
+    void markTile(int id, int room, int index) {
+        wt cell = room * 1200 + index;
+        if (m_dirty[id][cell])
+            return;
+
+        m_dirty[id][cell] = true;
+        m_dirtyList[id][m_dirtyCount[id]++] = cell;
+    };
+
+    // invalidate layer bitmaps
+    void invalidate() {
+        m_valid[0] = false;
+        m_valid[1] = false;
+    };
+
+    // sprites line render
+    void renderSprites(int id, int y, Uint32* out) {
+        for (int x = 0; x < 320; x++)
+            out[x] = 0x00000000;
+
+        for (int n = 0; n < m_binCount[id][y]; n++) {
+            Sprite* spr = &sprites[m_bins[id][y][n]];
+            int row = y - spr->y();
+
+            Uint8* src = (Uint8*)m_sur->pixels + m_sur->pitch * row + ((spr->id() | (sprc ? 0x400 : 0)) << 3);
+            Uint32* pal = m_argb + (spr->palette() << 4);
+            int sx = spr->x();
+
+            for (int i = 0; i < 8; i++) {
+                Uint32 color = pal[src[i]];
+                if (sx + i >= 0 && sx + i < 320 && (color >> 24))
+                    out[sx + i] = color;
+            };
+        };
+    };
+
+    // fps capper
+    void start() {
+        m_pace.begin(!m_turbo);
+        m_first = Uint64(m_frames++) * lineCount;
+        m_lines = m_first;
+
+        // zero this frame's measurements
+        m_probing = telemetry.active();
+        if (m_probing) {
+            m_sample = Sample();
+            m_sample.frame = m_frames - 1;
+            m_retired = 0;
+            m_mark = Pacer::now();
+            m_tsc = __rdtsc();
+        };
+
+        // skip rendering in turbo mode
+        m_draw = !m_turbo || ++m_skipped >= m_skip;
+        if (m_draw)
+            m_skipped = 0;
+    };
+    void stop(stepf action) {
+        // idle cpu runs to the end of the frame
+        if (m_probing) {
+            m_mark = Pacer::now();
+            m_tsc = __rdtsc();
+        };
+
+        // budgeted and turbo frames are done, only hold the frame rate
+        bool turbo = m_turbo;
+        if (m_budget || turbo) {
+            if (!turbo)
+                m_pace.wait(m_pace.end());
+            return;
+        };
+
+        while (Pacer::now() < m_pace.end()) {
+            // sleep while cpu is idle
+            m_retired++;
+            if (!action()) {
+                lap(PHASE_CPU);
+                if (!m_turbo)
+                    m_pace.wait(m_pace.end());
+                return;
+            };
+        };
+        lap(PHASE_CPU);
+    };
+    Pacer& pacer() {
+        return m_pace;
+    };
+
+    // measurements of the last frame
+    bool probing() {
+        return m_probing;
+    };
+    const Sample& sample() {
+        m_sample.instructions = m_retired;
+        return m_sample;
+    };
+
+    // continue into a speculative frame
+    void ahead(bool shown) {
+        m_first = Uint64(m_frames++) * lineCount;
+        m_lines = m_first;
+        m_draw = shown;
+    };
+    // is this frame drawn
+    bool drawing() {
+        return m_draw;
+    };
+    void draw(bool state) {
+        m_draw = state;
+    };
+
+    // copy emulated state
+    void save(Snapshot& snap) {
+        memcpy(snap.layers, layers, sizeof(layers));
+        memcpy(snap.sprites, sprites, sizeof(sprites));
+        memcpy(snap.argb, m_argb, sizeof(m_argb));
+        snap.vaddr = vaddr;
+        snap.saddr = saddr;
+        snap.head = head;
+        snap.nmib = nmib;
+        snap.sprb = sprb;
+        snap.lay1 = lay1;
+        snap.lay2 = lay2;
+        snap.sprc = sprc;
+        snap.held1 = m_held1;
+        snap.held2 = m_held2;
+        snap.frames = m_frames;
+        snap.first = m_first;
+        snap.lines = m_lines;
+    };
+    void load(const Snapshot& snap) {
+        // redraw only tiles that differ from the cached bitmaps
+        for (int l = 0; l < 2; l++) {
+            for (int r = 0; r < 4; r++) {
+                const Tile* from = snap.layers[l].data[r];
+                Tile* to = layers[l].data[r];
+                if (!memcmp(from, to, sizeof(layers[l].data[r])))
+                    continue;
+                for (int i = 0; i < 1200; i++) {
+                    if (from[i].p1 != to[i].p1 || from[i].p2 != to[i].p2)
+                        markTile(l, r, i);
+                };
+            };
+        };
+        memcpy(layers, snap.layers, sizeof(layers));
+        memcpy(sprites, snap.sprites, sizeof(sprites));
+
+        // rebuild palettes from color cache
+        memcpy(m_argb, snap.argb, sizeof(m_argb));
+        for (int i = 0; i < 256; i++) {
+            SDL_Color& c = palette(i);
+            c.a = m_argb[i] >> 24;
+            c.r = m_argb[i] >> 16;
+            c.g = m_argb[i] >> 8;
+            c.b = m_argb[i];
+        };
+
+        vaddr = snap.vaddr;
+        saddr = snap.saddr;
+        head = snap.head;
+        nmib = snap.nmib;
+        sprb = snap.sprb;
+        lay1 = snap.lay1;
+        lay2 = snap.lay2;
+        sprc = snap.sprc;
+        m_held1 = snap.held1;
+        m_held2 = snap.held2;
+        m_frames = snap.frames;
+        m_first = snap.first;
+        m_lines = snap.lines;
+    };
+
+    // set input for both pads directly
+    void input(dt keys) {
+        m_input = keys;
+    };
+
+    // run lines on instruction count, zero for wall clock
+    void budget(dt count) {
+        m_budget = count;
+    };
+
+    // last rendered frame
+    SDL_Surface* frame() {
+        return m_frame[m_back];
+    };
+
+    // emulated scanline counter
+    Uint64 lines() {
+        return m_lines;
+    };
+    // instructions executed, per frame while probing
+    Uint64 retired() {
+        return m_retired;
+    };
+
+    // audio interpolation mode
+    dt filter() {
+        return m_filter;
+    };
+
+    // is turbo mode active
+    bool turbo() {
+        return m_turbo;
+    };
+
+    // is window active
+    bool running() {
+        return m_run;
+    };
+    void quit() {
+        m_run = false;
+    };
+    // check nmi
+    bool nmi() {
+        return nmib;
+    };
+
+    // get key state
+    wt keys1() {
+        return m_held1 | (m_ju << 15);
+    };
+    wt keys2() {
+        return m_held2 | (m_ju << 15);
+    };
+    void setJoystickUse(bool state) {
+        m_ju = state;
+    };
+    void setMemory(bt* ram) {
+        m_ram = ram;
+    };
+
+    // get layer
+    Layer& layer(bool id) {
+        return layers[id];
+    };
+    // get sprite reference
+    Sprite& sprite(bt id) {
+        return sprites[id & 0x7F];
+    };
+    // get cgram reference
+    SDL_Surface* cgram() {
+        return m_sur;
+    };
+    // get palette color
+    SDL_Color& palette(bt id) {
+        return m_pal[id >> 4]->colors[id & 0xF];
+    };
+
+    // registers
+    void spriteAddr(bt data) {
+        saddr >>= 8;
+        saddr |= data << 8;
+    };
+    void vramAddr(bt data) {
+        vaddr >>= 8;
+        vaddr |= data << 8;
+    };
+    void scroll(bt data, bt id) {
+        switch (id) {
+            case 0:
+            layers[0].scrollx >>= 8;
+            layers[0].scrollx |= data << 8;
+            break;
+            case 1:
+            layers[0].scrolly >>= 8;
+            layers[0].scrolly |= data << 8;
+            break;
+            case 2:
+            layers[1].scrollx >>= 8;
+            layers[1].scrollx |= data << 8;
+            break;
+            case 3:
+            layers[1].scrolly >>= 8;
+            layers[1].scrolly |= data << 8;
+            break;
+        };
+    };
+
+    // I/O
+    void write(bt data) {
+        wt addr = vaddr;
+
+        if (addr >= 0x8000) {
+            switch (head & 0x3) {
+                case 0:
+                vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) + 1, 1200);
+                break;
+                case 1:
+                vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) - 1, 1200);
+                break;
+                case 2: {
+                    if ((vaddr & 0x7FF) == 0x4AF) {
+                        vaddr = vaddr & 0xF800;
+                        break;
+                    };
+                    vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) + 40, 1200);
+                    if (addr > vaddr) vaddr++;
+                };
+                break;
+                case 3: {
+                    if ((vaddr & 0x7FF) == 0) {
+                        vaddr = (vaddr & 0xF800) | 0x4AF;
+                        break;
+                    };
+                    vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) - 40, 1200);
+                    if (addr < vaddr) vaddr--;
+                };
+                break;
+            };
+
+            bt block = (addr >> 11) & 0xF;
+            wt offset = addr & 0x7FF;
+
+            if (offset < 1200) {
+                wt xc = offset % 40;
+                wt yc = offset / 40;
+
+                if (block >> 3)
+                    layers[(block >> 2) & 1].data[block & 3][yc * 40 + xc].p2 = data;
+                else
+                    layers[(block >> 2) & 1].data[block & 3][yc * 40 + xc].p1 = data;
+                markTile((block >> 2) & 1, block & 3, yc * 40 + xc);
+            };
+            return;
+        };
+        vaddr++;
+
+        if (addr < 0x200) {
+            bt id = addr >> 1;
+
+            if (addr & 1) {
+                palette(id).b = (data >> 4) * 0x11;
+                palette(id).a = (data & 15) * 0x11;
+            } else {
+                palette(id).r = (data >> 4) * 0x11;
+                palette(id).g = (data & 15) * 0x11;
+            };
+
+            // update color cache
+            SDL_Color& c = palette(id);
+            m_argb[id] = c.a << 24 | c.r << 16 | c.g << 8 | c.b;
+        };
+    };
+    bt read() {
+        wt addr = vaddr;
+
+        if (addr >= 0x8000) {
+            switch (head & 0x3) {
+                case 0:
+                vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) + 1, 1200);
+                break;
+                case 1:
+                vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) - 1, 1200);
+                break;
+                case 2: {
+                    if ((vaddr & 0x7FF) == 0x4AF) {
+                        vaddr = vaddr & 0xF800;
+                        break;
+                    };
+                    vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) + 40, 1200);
+                    if (addr > vaddr) vaddr++;
+                };
+                break;
+                case 3: {
+                    if ((vaddr & 0x7FF) == 0) {
+                        vaddr = (vaddr & 0xF800) | 0x4AF;
+                        break;
+                    };
+                    vaddr = (vaddr & 0xF800) + mod((vaddr & 0x7FF) - 40, 1200);
+                    if (addr < vaddr) vaddr--;
+                };
+                break;
+            };
+
+            bt block = (addr >> 11) & 0xF;
+            wt offset = addr & 0x7FF;
+
+            if (offset < 1200) {
+                wt xc = offset % 40;
+                wt yc = offset / 40;
+
+                if (block >> 3)
+                    return layers[(block >> 2) & 1].data[block & 3][yc * 40 + xc].p2;
+                return layers[(block >> 2) & 1].data[block & 3][yc * 40 + xc].p1;
+            };
+            return 0;
+        };
+        vaddr++;
+
+        return 0;
+    };
+    void control(bt data) {
+        nmib = data & 0x80;
+        sprb = data & 0x40;
+        lay1 = data & 0x20;
+        lay2 = data & 0x10;
+        sprc = data & 0x04;
+        head = data & 0x03;
+    };
+    void room(bt data) {
+        layers[0].roomy = data & 0x8;
+        layers[0].roomx = data & 0x4;
+        layers[1].roomy = data & 0x2;
+        layers[1].roomx = data & 0x1;
+    };
+
+    private:
+    // window control
+    SDL_Palette*  m_pal[16] = {};
+    SDL_Surface*  m_scr = null;
+    SDL_Renderer* m_ren = null;
+    SDL_Texture*  m_tex = null;
+    SDL_Surface*  m_frame[3] = {};
+    SDL_Surface*  m_sur = null;
+    SDL_Window*   m_win = null;
+    const Uint8* m_keystate;
+    std::atomic<bool> m_run {false};
+    std::atomic<bool> m_reset {false};
+    std::atomic<dt> m_input {0};
+    bool m_ju = false;
+    Pacer m_pace;
+
+    // turbo mode
+    std::atomic<bool> m_turbo {false};
+    std::atomic<dt> m_frames {0};
+    Uint64 m_first = 0;
+    Uint64 m_lines = 0;
+    dt m_budget = 0;
+    bool m_draw = true;
+    dt m_skip = 1;
+    dt m_skipped = 0;
+    Uint64 m_shown = 0;
+    Uint64 m_titleTime = 0;
+    dt m_titleFrames = 0;
+    st m_name = null;
+    wt m_keys1 = 0;
+    wt m_keys2 = 0;
+    wt m_held1 = 0;
+    wt m_held2 = 0;
+    bt m_scale = 1;
+    bool m_smooth = false;
+    std::atomic<dt> m_filter {0};
+
+    // frame measurements
+    bool m_probing = false;
+    Sample m_sample;
+    Uint64 m_retired = 0;
+    Uint64 m_mark = 0;
+    Uint64 m_tsc = 0;
+
+    // frame scaler
+    expandf m_expand;
+
+    // line compositor
+    compf m_compose;
+    Uint32 m_argb[256];
+    Uint32 m_line[5][320];
+    bt m_bins[3][240][128];
+    bt m_binCount[3][240];
+    bt* m_ram = null;
+
+    // triple buffer
+    std::atomic<int> m_swap {1};
+    SDL_sem* m_ready = null;
+    int m_back = 0;
+    int m_front = 2;
+
+    // layer bitmaps
+    bt m_cache[2][480][640];
+    bool m_valid[2] = {false, false};
+    bool m_dirty[2][4800];
+    wt m_dirtyList[2][4800];
+    int m_dirtyCount[2] = {0, 0};
+
+    // gpu data
+    Layer layers[2];
+    Sprite sprites[128];
+    wt vaddr;
+    wt saddr;
+    bt head;
+    bool nmib;
+    bool sprb;
+    bool lay1;
+    bool lay2;
+    bool sprc;
+};
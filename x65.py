@@ -0,0 +1,151 @@
+# -- batched console binding -- #
+
+"""Step many x65 consoles in lockstep through the batch library.
+
+Build the library from the single translation unit with X65_BATCH defined,
+next to this file under the name `load` looks for:
+
+    Linux:   g++ -O2 -fpermissive -fPIC -shared -DX65_BATCH core.cpp -lSDL2 -o libx65.so
+    Windows: g++ -O2 -fpermissive -shared -DX65_BATCH core.cpp -lSDL2 -lws2_32 -o x65.dll
+
+Frames, ram and rewards are views into arrays owned by the library, so they
+change in place on every step. `Shared` reads the region a running emulator
+exports with `--shm`.
+"""
+
+import ctypes
+import mmap
+import os
+import struct
+import sys
+
+try:
+    import numpy
+except ImportError:
+    numpy = None
+
+# library next to this file unless given
+DEFAULT_LIBRARY = os.path.join(os.path.dirname(os.path.abspath(__file__)), "x65.dll" if sys.platform == "win32" else "libx65.so")
+
+RAM_SIZE = 0x4000
+WIDTH = 320
+HEIGHT = 240
+
+
+def load(path=DEFAULT_LIBRARY):
+    lib = ctypes.CDLL(path)
+    lib.x65_create.restype = ctypes.c_void_p
+    lib.x65_create.argtypes = [ctypes.c_char_p, ctypes.c_uint, ctypes.c_uint, ctypes.c_ulonglong, ctypes.c_int]
+    lib.x65_destroy.argtypes = [ctypes.c_void_p]
+    lib.x65_step.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+    lib.x65_reset.argtypes = [ctypes.c_void_p, ctypes.c_uint]
+    lib.x65_frames.restype = ctypes.c_void_p
+    lib.x65_frames.argtypes = [ctypes.c_void_p]
+    lib.x65_ram.restype = ctypes.c_void_p
+    lib.x65_ram.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint)]
+    lib.x65_rewards.restype = ctypes.c_void_p
+    lib.x65_rewards.argtypes = [ctypes.c_void_p]
+    return lib
+
+
+class Batch:
+    """N consoles from one rom, stepped on a thread pool.
+
+    reward_addr names a 16-bit little endian counter in ram whose change per
+    step is the reward, or -1 for none. Actions are key words, pad 1 in the
+    low 16 bits and pad 2 in the high 16 bits.
+    """
+
+    def __init__(self, rom, count, threads=0, seed=0, reward_addr=-1, library=DEFAULT_LIBRARY):
+        self.lib = load(library)
+        self.count = count
+        self.handle = self.lib.x65_create(rom.encode(), count, threads, seed, reward_addr)
+        if not self.handle:
+            raise RuntimeError("failed to create consoles from %s" % rom)
+
+        # views over library arrays, no copies
+        stride = ctypes.c_uint()
+        frames = self.lib.x65_frames(self.handle)
+        ram = self.lib.x65_ram(self.handle, ctypes.byref(stride))
+        rewards = self.lib.x65_rewards(self.handle)
+        self.stride = stride.value
+        self.actions = (ctypes.c_uint32 * count)()
+
+        if numpy is not None:
+            flat = numpy.ctypeslib.as_array((ctypes.c_uint32 * (count * HEIGHT * WIDTH)).from_address(frames))
+            self.frames = flat.reshape(count, HEIGHT, WIDTH)
+            memory = numpy.ctypeslib.as_array((ctypes.c_uint8 * (self.stride * (count - 1) + RAM_SIZE)).from_address(ram))
+            self.ram = numpy.lib.stride_tricks.as_strided(memory, shape=(count, RAM_SIZE), strides=(self.stride, 1))
+            self.rewards = numpy.ctypeslib.as_array((ctypes.c_float * count).from_address(rewards))
+            self.actions = numpy.ctypeslib.as_array(self.actions)
+        else:
+            self.frames = [(ctypes.c_uint32 * (HEIGHT * WIDTH)).from_address(frames + i * HEIGHT * WIDTH * 4) for i in range(count)]
+            self.ram = [(ctypes.c_uint8 * RAM_SIZE).from_address(ram + i * self.stride) for i in range(count)]
+            self.rewards = (ctypes.c_float * count).from_address(rewards)
+
+    def step(self, actions=None):
+        """Run one frame on every console, returns frames, ram and rewards."""
+        if actions is not None:
+            self.actions[:] = actions
+        self.lib.x65_step(self.handle, ctypes.addressof(self.actions) if numpy is None else self.actions.ctypes.data)
+        return self.frames, self.ram, self.rewards
+
+    def reset(self, index):
+        self.lib.x65_reset(self.handle, index)
+
+    def close(self):
+        if self.handle:
+            self.lib.x65_destroy(self.handle)
+            self.handle = None
+
+    def __del__(self):
+        self.close()
+
+
+# shared memory region written by `x65 --shm <name>`
+SHARED_MAGIC = 0x53353658
+SEQUENCE = 16
+FRAME = 20
+PIXELS = 24
+RAM = PIXELS + WIDTH * HEIGHT * 4
+SHARED_SIZE = RAM + RAM_SIZE
+
+
+class Shared:
+    """Reader for the region a running emulator publishes every frame.
+
+    `pixels` and `ram` are live views into the mapping. `read` returns a
+    consistent copy of frame counter, pixels and ram using the seqlock.
+    """
+
+    def __init__(self, name):
+        if sys.platform == "win32":
+            self.map = mmap.mmap(-1, SHARED_SIZE, tagname=name, access=mmap.ACCESS_READ)
+        else:
+            # shm_open names live under /dev/shm on linux
+            with open("/dev/shm/" + name, "rb") as f:
+                self.map = mmap.mmap(f.fileno(), SHARED_SIZE, access=mmap.ACCESS_READ)
+        if struct.unpack_from("<I", self.map, 0)[0] != SHARED_MAGIC:
+            raise RuntimeError("%s is not an x65 region" % name)
+        view = memoryview(self.map)
+        self.pixels = view[PIXELS:RAM]
+        self.ram = view[RAM:SHARED_SIZE]
+
+    def sequence(self):
+        return struct.unpack_from("<I", self.map, SEQUENCE)[0]
+
+    def read(self):
+        while True:
+            before = self.sequence()
+            if before & 1:
+                continue
+            frame = struct.unpack_from("<I", self.map, FRAME)[0]
+            pixels = bytes(self.pixels)
+            ram = bytes(self.ram)
+            if self.sequence() == before:
+                return frame, pixels, ram
+
+    def close(self):
+        self.pixels.release()
+        self.ram.release()
+        self.map.close()